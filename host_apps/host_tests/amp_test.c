@@ -0,0 +1,366 @@
+/******************************************************************************
+ * @Title		:	Host Test: AMP Command Link
+ * @Filename	:	amp_test.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	17/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	gcc (host, HOST_BUILD)
+ * @Target		: 	PC (Linux, pthreads)
+ * @Platform	: 	-
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+/* Runs amp/amp.c (HOST_BUILD) with one thread per core:
+ *   - "CPU0" loops ampServiceRequests(); handleCommand() is a stub that
+ *     echoes a word of the frame, after an optional delay;
+ *   - "CPU1" (main) calls ampCallCpu0(), as the command parser, and
+ *     ampServiceComms(), as its main loop; uart1QueueResponse() is a stub
+ *     that records the deferred responses sent to the host.
+ * Checks a normal call, a call that times out (deferred, then its late
+ * response sent with its tag), a late response ahead of the next response,
+ * a BATCH record that times out (CMD_PENDING), a response too long for the
+ * caller (CMD_ERROR), a busy UART, and a random mix of fast and slow
+ * commands: each command runs once and is answered once.
+ * Returns 0 on success. */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp/amp.h"
+#include "utilities/cmd_handler.h"
+#include "utilities/logger.h"
+
+
+/* Test commands (byte 1 of the frame). Bytes 2 - 5: the word echoed;
+ * bytes 6 - 9: a delay (us) before the response. */
+#define TEST_CMD_ECHO				1U		// Echo after the delay
+#define TEST_CMD_GATED				2U		// Echo when the test opens the gate
+#define TEST_CMD_LONG				3U		// 64-byte response
+
+#define N_STRESS					400U
+#define SERVICE_TIMEOUT_US			1000000U
+
+
+/* CPU0 side */
+static volatile uint32_t	cpu0_stop = 0U;
+static volatile uint32_t	gate_open = 0U;
+static volatile uint32_t	n_executed[N_STRESS + 16U];
+
+/* CPU1 side: deferred responses sent to the host */
+static uint32_t				n_frames = 0U;
+static uint32_t				frame_tag[N_STRESS + 16U];
+static uint32_t				frame_word[N_STRESS + 16U];
+static uint32_t				uart_busy = 0U;
+static uint32_t				n_late_logged = 0U;
+static uint32_t				n_timeouts_logged = 0U;
+
+static int					failed = 0;
+
+
+
+/* ----- Host versions of the target functions used by amp.c ----- */
+
+void XTime_GetTime(XTime *Xtime_Global)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	*Xtime_Global = ((XTime)ts.tv_sec * 1000000000U) + (XTime)ts.tv_nsec;
+}
+
+
+void setResponseBytes(uint8_t *tx_buffer, uint32_t tx_data)
+{
+	tx_buffer[0] = (uint8_t)(tx_data >> 24);
+	tx_buffer[1] = (uint8_t)(tx_data >> 16);
+	tx_buffer[2] = (uint8_t)(tx_data >> 8);
+	tx_buffer[3] = (uint8_t)tx_data;
+}
+
+
+static uint32_t getWord(uint8_t *p_bytes)
+{
+	return (((uint32_t)p_bytes[0] << 24) | ((uint32_t)p_bytes[1] << 16)
+			| ((uint32_t)p_bytes[2] << 8) | (uint32_t)p_bytes[3]);
+}
+
+
+uint32_t handleCommand(uint8_t *rx_buffer, uint8_t *tx_buffer, uint32_t request_id)
+{
+	uint32_t word = getWord(rx_buffer + 2U);
+	uint32_t delay_us = getWord(rx_buffer + 6U);
+	uint32_t idx;
+
+	(void)request_id;
+	n_executed[word]++;
+
+	if (rx_buffer[1] == TEST_CMD_GATED)
+	{
+		while (gate_open == 0U)
+		{
+			sched_yield();
+		}
+		gate_open = 0U;
+	}
+	else if (delay_us != 0U)
+	{
+		usleep(delay_us);
+	}
+
+	if (rx_buffer[1] == TEST_CMD_LONG)
+	{
+		for (idx = 0U; idx < 16U; idx++)
+		{
+			setResponseBytes(tx_buffer + (idx * 4U), word);
+		}
+		return 64U;
+	}
+
+	setResponseBytes(tx_buffer, word);
+	return RESPONSE_NBYTES;
+}
+
+
+int uart1QueueResponse(uint32_t request_id, uint8_t *response, uint32_t n_bytes)
+{
+	if (uart_busy != 0U)
+	{
+		uart_busy--;
+		return XST_FAILURE;
+	}
+
+	if ((n_bytes != RESPONSE_NBYTES) || (n_frames >= (N_STRESS + 16U)))
+	{
+		printf("  bad deferred response: tag %u, %u bytes\n", request_id, n_bytes);
+		failed = 1;
+		return XST_SUCCESS;
+	}
+
+	frame_tag[n_frames] = request_id;
+	frame_word[n_frames] = getWord(response);
+	n_frames++;
+	return XST_SUCCESS;
+}
+
+
+uint32_t uart1WorkPending(void)
+{
+	return 0U;
+}
+
+
+void uart1BaudTick(void)
+{
+}
+
+
+void logWrite(uint32_t id, uint32_t n_args, uint32_t arg0, uint32_t arg1,
+				uint32_t arg2, uint32_t arg3)
+{
+	(void)n_args;
+	(void)arg0;
+	(void)arg1;
+	(void)arg2;
+	(void)arg3;
+
+	if (id == LOG_AMP_LATE)
+	{
+		n_late_logged++;
+	}
+	else if (id == LOG_AMP_TIMEOUT)
+	{
+		n_timeouts_logged++;
+	}
+}
+
+
+void logDrain(void)
+{
+}
+
+
+
+/* ----- Test ----- */
+
+static void *cpu0Main(void *p_arg)
+{
+	(void)p_arg;
+
+	while (cpu0_stop == 0U)
+	{
+		if (ampServiceRequests() == 0U)
+		{
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+
+static uint32_t call(uint32_t cmd, uint32_t word, uint32_t delay_us, uint32_t request_id,
+						uint8_t *tx_buffer, uint32_t tx_nbytes)
+{
+	uint8_t frame[CMD_FRAME_NBYTES] = {0U};
+
+	frame[1] = (uint8_t)cmd;
+	setResponseBytes(frame + 2U, word);
+	setResponseBytes(frame + 6U, delay_us);
+
+	return ampCallCpu0(frame, CMD_FRAME_NBYTES, tx_buffer, tx_nbytes, request_id);
+}
+
+
+/* CPU1 main loop until nothing is left from CPU0 (or a timeout) */
+static void serviceComms(uint32_t n_frames_expected)
+{
+	XTime t_start;
+	XTime t_now;
+
+	XTime_GetTime(&t_start);
+	do
+	{
+		(void)ampServiceComms();
+		XTime_GetTime(&t_now);
+	} while ( ((n_frames < n_frames_expected) || (ampCommsWorkPending() != 0U)
+				|| (ampRequestsPending() != 0U))
+			&& ((t_now - t_start) < ((XTime)SERVICE_TIMEOUT_US * AMP_COUNTS_PER_US)) );
+}
+
+
+static void check(const char *p_name, int ok)
+{
+	printf("  %-52s %s\n", p_name, (ok != 0) ? "ok" : "FAILED");
+	if (ok == 0)
+	{
+		failed = 1;
+	}
+}
+
+
+int main(void)
+{
+	pthread_t cpu0;
+	uint8_t tx[CMD_MAX_RESPONSE_NBYTES];
+	uint32_t n_tx;
+	uint32_t n_direct[N_STRESS];
+	uint32_t idx;
+	uint32_t k;
+	uint32_t word;
+	int ok;
+
+	(void)ampInit();
+	pthread_create(&cpu0, NULL, cpu0Main, NULL);
+
+	/* Answered in time */
+	n_tx = call(TEST_CMD_ECHO, 1U, 0U, 1U, tx, CMD_MAX_RESPONSE_NBYTES);
+	check("normal call: response returned", (n_tx == RESPONSE_NBYTES) && (getWord(tx) == 1U));
+
+	/* Timeout: deferred, then the late response with its tag */
+	n_tx = call(TEST_CMD_GATED, 2U, 0U, 0x22U, tx, CMD_MAX_RESPONSE_NBYTES);
+	check("slow call: deferred", n_tx == 0U);
+	gate_open = 1U;
+	serviceComms(1U);
+	check("slow call: late response sent once, with its tag",
+			(n_frames == 1U) && (frame_tag[0] == 0x22U) && (frame_word[0] == 2U)
+			&& (n_executed[2] == 1U));
+
+	/* A late response ahead of the response of the next call */
+	n_tx = call(TEST_CMD_GATED, 3U, 0U, 0x33U, tx, CMD_MAX_RESPONSE_NBYTES);
+	gate_open = 1U;
+	n_tx |= call(TEST_CMD_ECHO, 4U, 0U, 0x44U, tx, CMD_MAX_RESPONSE_NBYTES) << 8;
+	check("late response first, then the next response",
+			(n_tx == (RESPONSE_NBYTES << 8)) && (getWord(tx) == 4U) && (n_frames == 2U)
+			&& (frame_tag[1] == 0x33U) && (frame_word[1] == 3U));
+
+	/* BATCH record: no tag, CMD_PENDING; the late response is not sent */
+	n_tx = call(TEST_CMD_GATED, 5U, 0U, CMD_REQUEST_ID_NONE, tx, RESPONSE_NBYTES);
+	check("BATCH record timeout: CMD_PENDING",
+			(n_tx == RESPONSE_NBYTES) && (getWord(tx) == CMD_PENDING));
+	gate_open = 1U;
+	serviceComms(0U);
+	check("BATCH record: late response not sent", (n_frames == 2U) && (n_executed[5] == 1U));
+
+	/* Too long for the caller */
+	n_tx = call(TEST_CMD_LONG, 6U, 0U, CMD_REQUEST_ID_NONE, tx, RESPONSE_NBYTES);
+	check("response too long: CMD_ERROR", (n_tx == RESPONSE_NBYTES) && (getWord(tx) == CMD_ERROR));
+
+	/* UART busy: the late response waits in the queue */
+	n_tx = call(TEST_CMD_GATED, 7U, 0U, 0x77U, tx, CMD_MAX_RESPONSE_NBYTES);
+	uart_busy = 3U;
+	gate_open = 1U;
+	serviceComms(3U);
+	check("UART busy: late response sent when it can be",
+			(n_tx == 0U) && (uart_busy == 0U) && (n_frames == 3U) && (frame_tag[2] == 0x77U)
+			&& (n_executed[7] == 1U));
+
+	check("timeouts and late responses logged", (n_timeouts_logged == 4U) && (n_late_logged == 3U));
+
+	/* Random mix: every command runs once and is answered once, either
+	 * by its call or by a late response */
+	n_frames = 0U;
+	srand(1U);
+	for (idx = 0U; idx < N_STRESS; idx++)
+	{
+		word = 16U + idx;
+		n_executed[word] = 0U;
+		n_tx = call(TEST_CMD_ECHO, word, ((rand() % 10) == 0) ? (8000U + ((uint32_t)rand() % 6000U)) : 0U,
+					word, tx, CMD_MAX_RESPONSE_NBYTES);
+		n_direct[idx] = ((n_tx == RESPONSE_NBYTES) && (getWord(tx) == word)) ? 1U : 0U;
+		if ((n_tx != 0U) && (n_direct[idx] == 0U))
+		{
+			printf("  command %u: bad response\n", word);
+			failed = 1;
+		}
+		(void)ampServiceComms();
+	}
+	serviceComms(0U);
+
+	ok = 1;
+	for (idx = 0U; idx < N_STRESS; idx++)
+	{
+		word = 16U + idx;
+		for (k = 0U; k < n_frames; k++)
+		{
+			if (frame_tag[k] == word)
+			{
+				n_direct[idx] += (frame_word[k] == word) ? 1U : 100U;
+			}
+		}
+		if ((n_direct[idx] != 1U) || (n_executed[word] != 1U))
+		{
+			printf("  command %u: answered %u times, run %u times\n", word, n_direct[idx],
+					n_executed[word]);
+			ok = 0;
+		}
+	}
+	printf("  random mix: %u commands, %u late responses\n", N_STRESS, n_frames);
+	check("random mix: each command run and answered once", ok);
+
+	cpu0_stop = 1U;
+	pthread_join(cpu0, NULL);
+
+	printf("amp_test: %s\n", (failed != 0) ? "FAILED" : "passed");
+	return failed;
+}
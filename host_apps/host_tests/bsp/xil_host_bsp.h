@@ -0,0 +1,284 @@
+/******************************************************************************
+ * @Title		:	Host Stand-in for the Xilinx Standalone BSP
+ * @Filename	:	xil_host_bsp.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	17/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	gcc (host)
+ * @Target		: 	PC (Linux)
+ * @Platform	: 	-
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+#ifndef HOST_TESTS_BSP_XIL_HOST_BSP_H_
+#define HOST_TESTS_BSP_XIL_HOST_BSP_H_
+
+
+/* -------- Host BSP -------*/
+/*	The BSP headers of this directory (xil_types.h, xuartps.h, ...) all
+*	include this file. It declares just enough of the BSP for the sw_proj10
+*	modules that touch the hardware (e.g. uart/ps7_uart1_if.c) to build
+*	unchanged on a PC, without HOST_BUILD:
+*	  - types, status codes, barriers (compiler barriers only) and the
+*	    xparameters.h values used by the sources;
+*	  - the driver types and functions of the headers included by tasks.h.
+*	    The test defines the functions it needs;
+*	  - assertions, which call hostAssert() of the test;
+*	  - the UART registers: XUartPs_ReadReg()/XUartPs_WriteReg() call
+*	    hostUartReadReg()/hostUartWriteReg(), the register model of the
+*	    test (FIFOs, status and interrupt registers).
+*	Xil_In32()/Xil_Out32() access host memory: build with -no-pie, so that
+*	the addresses of static test data fit in 32 bits.
+*
+*	Only the BSP items used by the sources are here; add more as needed. */
+
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+/* -------- xil_types.h, xstatus.h -------*/
+typedef uint8_t			u8;
+typedef uint16_t		u16;
+typedef uint32_t		u32;
+typedef uint64_t		u64;
+typedef int32_t			s32;
+typedef char			char8;
+typedef uintptr_t		UINTPTR;
+
+#define TRUE						1U
+#define FALSE						0U
+
+#define XST_SUCCESS					0L
+#define XST_FAILURE					1L
+
+
+/* -------- xparameters.h -------*/
+#define XPAR_CPU_ID							0U
+#define XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ	666666687U
+#define XPAR_PS7_UART_1_DEVICE_ID			0U
+#define XPAR_PS7_UART_1_UART_CLK_FREQ_HZ	100000000U
+#define XPAR_PS7_TTC_0_DEVICE_ID			0U
+#define XPAR_PS7_SCUWDT_0_DEVICE_ID			0U
+#define XPAR_PS7_SCUGIC_0_DEVICE_ID			0U
+#define XPAR_PS7_SCUGIC_0_DIST_BASEADDR		0xF8F01000U
+#define XPAR_PS7_GPIO_0_DEVICE_ID			0U
+#define XPAR_AXI_GPIO_0_DEVICE_ID			0U
+#define XPS_UART1_INT_ID					82U
+#define XPS_TTC0_0_INT_ID					42U
+
+
+/* -------- xpseudo_asm.h, xil_exception.h -------*/
+#define dmb()						__asm__ volatile("" ::: "memory")
+#define dsb()						__asm__ volatile("" ::: "memory")
+#define isb()						__asm__ volatile("" ::: "memory")
+#define wfi()						__asm__ volatile("" ::: "memory")
+#define sev()						__asm__ volatile("" ::: "memory")
+#define mfcpsr()					0U
+#define mtcpsr(v)					((void)(v))
+
+#define XIL_EXCEPTION_ID_INT		5U
+#define XIL_EXCEPTION_IRQ			0x80U
+#define XREG_CPSR_IRQ_ENABLE		0x80U
+
+typedef void (*Xil_ExceptionHandler)(void *data);
+typedef void (*Xil_InterruptHandler)(void *data);
+
+void Xil_ExceptionInit(void);
+void Xil_ExceptionEnable(void);
+void Xil_ExceptionDisable(void);
+void Xil_ExceptionRegisterHandler(u32 Exception_id, Xil_ExceptionHandler Handler, void *Data);
+
+#define Xil_EnableNestedInterrupts()	do { } while (0)
+#define Xil_DisableNestedInterrupts()	do { } while (0)
+
+/* An assertion that fails calls hostAssert() of the test */
+void hostAssert(const char *p_file, int line);
+
+#define Xil_AssertVoid(expr)		((expr) ? (void)0 : hostAssert(__FILE__, __LINE__))
+#define Xil_AssertNonvoid(expr)		((expr) ? (void)0 : hostAssert(__FILE__, __LINE__))
+#define Xil_AssertVoidAlways()		hostAssert(__FILE__, __LINE__)
+
+
+/* -------- xil_io.h, xil_mmu.h, xtime_l.h -------*/
+static inline u32 Xil_In32(UINTPTR Addr)
+{
+	return *(volatile u32 *)Addr;
+}
+
+static inline void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	*(volatile u32 *)Addr = Value;
+}
+
+void Xil_SetTlbAttributes(UINTPTR addr, u32 attrib);
+
+typedef u64 XTime;
+#define COUNTS_PER_SECOND			(XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2U)
+void XTime_GetTime(XTime *Xtime_Global);
+
+
+/* -------- xscugic.h -------*/
+typedef struct {
+	u16 DeviceId;
+	u32 CpuBaseAddress;
+	u32 DistBaseAddress;
+} XScuGic_Config;
+
+typedef struct {
+	XScuGic_Config *Config;
+	u32 IsReady;
+} XScuGic;
+
+#define XScuGic_WriteReg(base, offset, data)	((void)(base), (void)(offset), (void)(data))
+#define XScuGic_ReadReg(base, offset)			((void)(base), (void)(offset), 0U)
+#define XScuGic_CPUWriteReg(inst, offset, data)	((void)(inst), (void)(offset), (void)(data))
+#define XScuGic_CPUReadReg(inst, offset)		((void)(inst), (void)(offset), 0U)
+
+#define XSCUGIC_CPU_PRIOR_OFFSET	0x04U
+#define XSCUGIC_RUN_PRIOR_OFFSET	0x14U
+#define XSCUGIC_SFI_TRIG_OFFSET		0xF00U
+#define XSCUGIC_PENDING_SET_OFFSET	0x200U
+#define XSCUGIC_PEND_SET_OFFSET_CALC(id)	(XSCUGIC_PENDING_SET_OFFSET + (((id) / 32U) * 4U))
+
+
+/* -------- xuartps.h -------*/
+typedef struct {
+	u16 DeviceId;
+	u32 BaseAddress;
+	u32 InputClockHz;
+	s32 ModemPinsConnected;
+} XUartPs_Config;
+
+typedef void (*XUartPs_Handler)(void *CallBackRef, u32 Event, u32 EventData);
+
+typedef struct {
+	XUartPs_Config Config;
+	u32 IsReady;
+	u32 BaudRate;
+	XUartPs_Handler Handler;
+	void *CallBackRef;
+} XUartPs;
+
+XUartPs_Config *XUartPs_LookupConfig(u16 DeviceId);
+s32 XUartPs_CfgInitialize(XUartPs *InstancePtr, XUartPs_Config *Config, u32 EffectiveAddr);
+s32 XUartPs_SelfTest(XUartPs *InstancePtr);
+u32 XUartPs_Send(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes);
+void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr, void *CallBackRef);
+void XUartPs_SetInterruptMask(XUartPs *InstancePtr, u32 Mask);
+void XUartPs_SetFifoThreshold(XUartPs *InstancePtr, u8 TriggerLevel);
+void XUartPs_SetRecvTimeout(XUartPs *InstancePtr, u8 RecvTimeout);
+void XUartPs_SetOperMode(XUartPs *InstancePtr, u8 OperationMode);
+s32 XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate);
+
+/* Register model of the test */
+u32 hostUartReadReg(u32 BaseAddress, u32 RegOffset);
+void hostUartWriteReg(u32 BaseAddress, u32 RegOffset, u32 RegisterValue);
+
+#define XUartPs_ReadReg(base, offset)			hostUartReadReg((base), (offset))
+#define XUartPs_WriteReg(base, offset, data)	hostUartWriteReg((base), (offset), (data))
+#define XUartPs_IsReceiveData(base) \
+	((XUartPs_ReadReg((base), XUARTPS_SR_OFFSET) & XUARTPS_SR_RXEMPTY) != XUARTPS_SR_RXEMPTY)
+#define XUartPs_IsTransmitFull(base) \
+	((XUartPs_ReadReg((base), XUARTPS_SR_OFFSET) & XUARTPS_SR_TXFULL) == XUARTPS_SR_TXFULL)
+
+#define XUARTPS_CR_OFFSET			0x00U
+#define XUARTPS_IER_OFFSET			0x08U
+#define XUARTPS_IDR_OFFSET			0x0CU
+#define XUARTPS_IMR_OFFSET			0x10U
+#define XUARTPS_ISR_OFFSET			0x14U
+#define XUARTPS_SR_OFFSET			0x2CU
+#define XUARTPS_FIFO_OFFSET			0x30U
+
+#define XUARTPS_IXR_RXOVR			0x00000001U
+#define XUARTPS_IXR_RXEMPTY			0x00000002U
+#define XUARTPS_IXR_RXFULL			0x00000004U
+#define XUARTPS_IXR_TXEMPTY			0x00000008U
+#define XUARTPS_IXR_TXFULL			0x00000010U
+#define XUARTPS_IXR_OVER			0x00000020U
+#define XUARTPS_IXR_FRAMING			0x00000040U
+#define XUARTPS_IXR_PARITY			0x00000080U
+#define XUARTPS_IXR_TOUT			0x00000100U
+#define XUARTPS_IXR_RBRK			0x00002000U
+
+#define XUARTPS_SR_RXEMPTY			0x00000002U
+#define XUARTPS_SR_TXEMPTY			0x00000008U
+#define XUARTPS_SR_TXFULL			0x00000010U
+#define XUARTPS_SR_TACTIVE			0x00000800U
+
+#define XUARTPS_FIFO_SIZE			64U
+#define XUARTPS_OPER_MODE_NORMAL	0x00U
+#define XUARTPS_MAX_RATE			6240000U
+#define XUARTPS_MIN_RATE			110U
+
+#define XUARTPS_EVENT_RECV_DATA			1U
+#define XUARTPS_EVENT_RECV_TOUT			2U
+#define XUARTPS_EVENT_SENT_DATA			3U
+#define XUARTPS_EVENT_RECV_ERROR		4U
+#define XUARTPS_EVENT_MODEM				5U
+#define XUARTPS_EVENT_PARE_FRAME_BRKE	6U
+#define XUARTPS_EVENT_RECV_ORERR		7U
+
+
+/* -------- xttcps.h -------*/
+typedef struct {
+	u16 DeviceId;
+	u32 BaseAddress;
+	u32 InputClockHz;
+} XTtcPs_Config;
+
+typedef struct {
+	XTtcPs_Config Config;
+	u32 IsReady;
+} XTtcPs;
+
+
+/* -------- xscuwdt.h -------*/
+typedef struct {
+	u16 DeviceId;
+	u32 BaseAddr;
+} XScuWdt_Config;
+
+typedef struct {
+	XScuWdt_Config Config;
+	u32 IsReady;
+} XScuWdt;
+
+
+/* -------- xgpio.h, xgpiops.h -------*/
+typedef struct {
+	u32 BaseAddress;
+	u32 IsReady;
+} XGpio;
+
+typedef struct {
+	u16 DeviceId;
+	u32 BaseAddr;
+} XGpioPs_Config;
+
+typedef struct {
+	XGpioPs_Config GpioConfig;
+	u32 IsReady;
+} XGpioPs;
+
+
+#endif /* HOST_TESTS_BSP_XIL_HOST_BSP_H_ */
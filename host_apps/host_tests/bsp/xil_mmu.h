@@ -0,0 +1,2 @@
+/* Host build: see xil_host_bsp.h */
+#include "xil_host_bsp.h"
@@ -0,0 +1,219 @@
+/******************************************************************************
+ * @Title		:	Host Test: Lock-Free Concurrency Primitives
+ * @Filename	:	concurrency_test.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	17/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	gcc (host, HOST_BUILD)
+ * @Target		: 	PC (Linux, pthreads)
+ * @Platform	: 	-
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+/* Exercises utilities/concurrency.h with one thread per context:
+ *   - seqlock: a writer thread updates a 4-word block; the reader checks
+ *     that every copy it takes is consistent;
+ *   - atomicFetchAdd(): two threads add to one counter; no update is lost;
+ *   - atomicCas(): a producer adds ticks with atomicFetchAdd(), a consumer
+ *     takes them one at a time with atomicCas(), as the AMP tick count of
+ *     CPU1 (amp.c); every tick is taken exactly once.
+ * Returns 0 on success. */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#include "utilities/concurrency.h"
+
+
+#define N_ITER						1000000U
+
+
+static seqlock_t			Lock;
+static volatile uint32_t	Block[4];
+static volatile uint32_t	writer_done = 0U;
+
+static volatile uint32_t	counter = 0U;
+static volatile uint32_t	ticks = 0U;
+static volatile uint32_t	ticks_added = 0U;
+static volatile uint32_t	ticks_taken = 0U;
+
+
+
+static void *seqlockWriter(void *p_arg)
+{
+
+	uint32_t idx;
+
+	(void)p_arg;
+
+	for (idx = 1U; idx <= N_ITER; idx++)
+	{
+		seqlockWriteBegin(&Lock);
+		Block[0] = idx;
+		Block[1] = idx * 3U;
+		Block[2] = ~idx;
+		Block[3] = idx ^ 0x5A5A5A5AU;
+		seqlockWriteEnd(&Lock);
+
+		if ((idx & 1023U) == 0U)
+		{
+			sched_yield();
+		}
+	}
+
+	writer_done = 1U;
+	return NULL;
+
+}
+
+
+
+static void *fetchAdder(void *p_arg)
+{
+
+	uint32_t idx;
+
+	(void)p_arg;
+
+	for (idx = 0U; idx < N_ITER; idx++)
+	{
+		(void)atomicFetchAdd(&counter, 1U);
+	}
+
+	return NULL;
+
+}
+
+
+
+static void *tickProducer(void *p_arg)
+{
+
+	uint32_t idx;
+
+	(void)p_arg;
+
+	for (idx = 0U; idx < N_ITER; idx++)
+	{
+		(void)atomicFetchAdd(&ticks, 1U);
+	}
+
+	ticks_added = 1U;
+	return NULL;
+
+}
+
+
+
+static void *tickConsumer(void *p_arg)
+{
+
+	uint32_t n_ticks;
+
+	(void)p_arg;
+
+	/* Take one tick at a time, as ampServiceComms() */
+	while ((ticks_added == 0U) || (ticks != 0U))
+	{
+		do
+		{
+			n_ticks = ticks;
+		} while ((n_ticks != 0U) && (atomicCas(&ticks, n_ticks, n_ticks - 1U) != n_ticks));
+
+		if (n_ticks != 0U)
+		{
+			ticks_taken++;
+		}
+	}
+
+	return NULL;
+
+}
+
+
+
+int main(void)
+{
+
+	pthread_t writer;
+	pthread_t adder[2];
+	pthread_t producer;
+	pthread_t consumer;
+	uint32_t copy[4];
+	uint32_t seq;
+	uint32_t n_reads = 0U;
+	uint32_t n_torn = 0U;
+	uint32_t k;
+	int failed = 0;
+
+	/* A consistent block (idx 0) for reads before the first write */
+	seqlockInit(&Lock);
+	Block[0] = 0U;
+	Block[1] = 0U;
+	Block[2] = ~0U;
+	Block[3] = 0x5A5A5A5AU;
+
+	pthread_create(&writer, NULL, seqlockWriter, NULL);
+	pthread_create(&adder[0], NULL, fetchAdder, NULL);
+	pthread_create(&adder[1], NULL, fetchAdder, NULL);
+	pthread_create(&producer, NULL, tickProducer, NULL);
+	pthread_create(&consumer, NULL, tickConsumer, NULL);
+
+	/* Seqlock reader */
+	while (writer_done == 0U)
+	{
+		do
+		{
+			seq = seqlockReadBegin(&Lock);
+			for (k = 0U; k < 4U; k++)
+			{
+				copy[k] = Block[k];
+			}
+		} while (seqlockReadRetry(&Lock, seq) != 0U);
+
+		if ( (copy[1] != (copy[0] * 3U)) || (copy[2] != ~copy[0])
+				|| (copy[3] != (copy[0] ^ 0x5A5A5A5AU)) )
+		{
+			n_torn++;
+		}
+		n_reads++;
+		sched_yield();
+	}
+
+	pthread_join(writer, NULL);
+	pthread_join(adder[0], NULL);
+	pthread_join(adder[1], NULL);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	printf("seqlock:        %u reads, %u torn\n", n_reads, n_torn);
+	printf("atomicFetchAdd: %u (expected %u)\n", counter, 2U * N_ITER);
+	printf("atomicCas:      %u ticks taken (expected %u)\n", ticks_taken, N_ITER);
+
+	if ((n_torn != 0U) || (counter != (2U * N_ITER)) || (ticks_taken != N_ITER))
+	{
+		failed = 1;
+	}
+
+	printf("concurrency_test: %s\n", (failed != 0) ? "FAILED" : "passed");
+	return failed;
+
+}
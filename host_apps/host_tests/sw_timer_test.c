@@ -0,0 +1,283 @@
+/******************************************************************************
+ * @Title		:	Host Test: Software Timer Wheel
+ * @Filename	:	sw_timer_test.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	17/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	gcc (host, HOST_BUILD)
+ * @Target		: 	PC (Linux)
+ * @Platform	: 	-
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+/* Checks utilities/sw_timer.c against a reference model: for each timer,
+ * whether it runs, the tick it is due (swTimerNow() in its callback), and
+ * its period.
+ *   - N_TIMERS timers are started (one-shot and periodic, timeouts from 1
+ *     tick to all levels of the wheel), restarted and stopped at random
+ *     for N_TICKS ticks, from the test and from the callbacks (including
+ *     a callback restarting or stopping its own timer). Every callback
+ *     must come on the tick the model expects, and no timer may be left
+ *     overdue;
+ *   - the range checks of swTimerStart();
+ *   - the longest timeout (SW_TIMER_MAX_TICKS), through every level.
+ * Returns 0 on success. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utilities/sw_timer.h"
+
+
+#define N_TIMERS					500U
+#define N_TICKS						3000000U
+
+
+static sw_timer_t	Timer[N_TIMERS];
+
+/* Reference model */
+static uint32_t		running[N_TIMERS];
+static uint32_t		due[N_TIMERS];
+static uint32_t		period[N_TIMERS];
+
+static uint32_t		n_fired = 0U;
+static uint32_t		n_errors = 0U;
+static uint32_t		n_checks = 0U;
+static uint32_t		in_callback = 0U;
+
+
+
+static void error(const char *p_what, uint32_t idx)
+{
+	if (n_errors < 10U)
+	{
+		printf("  tick %u, timer %u: %s (running %u, due %u, period %u)\n", swTimerNow(), idx,
+				p_what, running[idx], due[idx], period[idx]);
+	}
+	n_errors++;
+}
+
+
+/* A timer is stopped or restarted: it must not be overdue. Between ticks,
+ * every timer due by swTimerNow() has been called; in a callback, a timer
+ * due in this tick may not have been yet. */
+static void checkNotOverdue(uint32_t idx)
+{
+	n_checks++;
+	if ((running[idx] != 0U) && ((int32_t)(due[idx] - swTimerNow()) < (1 - (int32_t)in_callback)))
+	{
+		error("overdue", idx);
+	}
+}
+
+
+static void startTimer(uint32_t idx, uint32_t ticks, uint32_t reload)
+{
+	checkNotOverdue(idx);
+	if (swTimerStart(&Timer[idx], ticks, reload) != XST_SUCCESS)
+	{
+		error("start failed", idx);
+	}
+	running[idx] = 1U;
+	due[idx] = swTimerNow() + ticks;
+	period[idx] = reload;
+}
+
+
+static void stopTimer(uint32_t idx)
+{
+	checkNotOverdue(idx);
+	swTimerStop(&Timer[idx]);
+	running[idx] = 0U;
+}
+
+
+/* Timeouts over every level of the wheel */
+static uint32_t randomTicks(void)
+{
+	switch (rand() % 4)
+	{
+	case 0:		return 1U + ((uint32_t)rand() % SW_TIMER_SLOTS);
+	case 1:		return 1U + ((uint32_t)rand() % 5000U);
+	case 2:		return 1U + ((uint32_t)rand() % 300000U);
+	default:	return 1U + ((uint32_t)rand() % 4000000U);
+	}
+}
+
+
+static void timerCallback(void *p_arg)
+{
+	uint32_t idx = (uint32_t)(uintptr_t)p_arg;
+
+	n_fired++;
+	in_callback = 1U;
+	if ((running[idx] == 0U) || (due[idx] != swTimerNow()))
+	{
+		error("called on the wrong tick", idx);
+	}
+
+	if (period[idx] != 0U)
+	{
+		due[idx] += period[idx];
+		if (swTimerIsRunning(&Timer[idx]) == 0U)
+		{
+			error("periodic timer not restarted", idx);
+		}
+	}
+	else
+	{
+		running[idx] = 0U;
+		if (swTimerIsRunning(&Timer[idx]) != 0U)
+		{
+			error("one-shot timer still running", idx);
+		}
+	}
+
+	/* Control timers from the callback, sometimes its own */
+	switch (rand() % 16)
+	{
+	case 0:
+		stopTimer((uint32_t)rand() % N_TIMERS);
+		break;
+	case 1:
+		startTimer((uint32_t)rand() % N_TIMERS, randomTicks(), 0U);
+		break;
+	case 2:
+		stopTimer(idx);
+		break;
+	case 3:
+		startTimer(idx, 1U + ((uint32_t)rand() % 1000U), ((rand() % 2) == 0) ? 0U : 1U + ((uint32_t)rand() % 1000U));
+		break;
+	default:
+		break;
+	}
+
+	in_callback = 0U;
+}
+
+
+static void maxCallback(void *p_arg)
+{
+	*(uint32_t *)p_arg = swTimerNow();
+}
+
+
+static void check(const char *p_name, int ok)
+{
+	printf("  %-52s %s\n", p_name, (ok != 0) ? "ok" : "FAILED");
+	if (ok == 0)
+	{
+		n_errors++;
+	}
+}
+
+
+int main(void)
+{
+	sw_timer_t no_func;
+	sw_timer_t t_max;
+	sw_timer_t t_mid;
+	uint32_t fired_max = 0U;
+	uint32_t fired_mid = 0U;
+	uint32_t t_start;
+	uint32_t tick;
+	uint32_t idx;
+	uint32_t n_overdue = 0U;
+	uint32_t n_state = 0U;
+
+	srand(1U);
+	for (idx = 0U; idx < N_TIMERS; idx++)
+	{
+		swTimerInit(&Timer[idx], timerCallback, (void *)(uintptr_t)idx);
+	}
+
+	/* ----- Random start, restart and stop ----- */
+	for (tick = 0U; tick < N_TICKS; tick++)
+	{
+		if ((rand() % 4) == 0)
+		{
+			startTimer((uint32_t)rand() % N_TIMERS, randomTicks(),
+						((rand() % 4) == 0) ? 1U + ((uint32_t)rand() % 50000U) : 0U);
+		}
+		if ((rand() % 5) == 0)
+		{
+			stopTimer((uint32_t)rand() % N_TIMERS);
+		}
+
+		swTimerTick();
+
+		/* Every timer due by now has been called */
+		if ((tick % 64U) == 0U)
+		{
+			for (idx = 0U; idx < N_TIMERS; idx++)
+			{
+				checkNotOverdue(idx);
+			}
+		}
+	}
+
+	for (idx = 0U; idx < N_TIMERS; idx++)
+	{
+		if ((running[idx] != 0U) && ((int32_t)(due[idx] - swTimerNow()) <= 0))
+		{
+			n_overdue++;
+		}
+		if (swTimerIsRunning(&Timer[idx]) != running[idx])
+		{
+			n_state++;
+		}
+	}
+
+	printf("  %u timers, %u ticks: %u callbacks, %u checks\n", N_TIMERS, N_TICKS, n_fired, n_checks);
+	check("random timers: every callback on its tick", n_errors == 0U);
+	check("random timers: none overdue, running state as model", (n_overdue == 0U) && (n_state == 0U));
+
+	for (idx = 0U; idx < N_TIMERS; idx++)
+	{
+		swTimerStop(&Timer[idx]);
+	}
+
+	/* ----- Range checks ----- */
+	swTimerInit(&no_func, NULL, NULL);
+	check("range: 0 ticks, too long, no callback",
+			(swTimerStart(&Timer[0], 0U, 0U) == XST_FAILURE)
+			&& (swTimerStart(&Timer[0], SW_TIMER_MAX_TICKS + 1U, 0U) == XST_FAILURE)
+			&& (swTimerStart(&Timer[0], 1U, SW_TIMER_MAX_TICKS + 1U) == XST_FAILURE)
+			&& (swTimerStart(&no_func, 1U, 0U) == XST_FAILURE)
+			&& (swTimerIsRunning(&Timer[0]) == 0U));
+
+	/* ----- Longest timeout, and one moved down from level 4 ----- */
+	swTimerInit(&t_max, maxCallback, &fired_max);
+	swTimerInit(&t_mid, maxCallback, &fired_mid);
+	t_start = swTimerNow();
+	(void)swTimerStart(&t_max, SW_TIMER_MAX_TICKS, 0U);
+	(void)swTimerStart(&t_mid, (1U << (SW_TIMER_BITS * 4U)) + 5U, 0U);
+	for (tick = 0U; tick < (SW_TIMER_MAX_TICKS + 10U); tick++)
+	{
+		swTimerTick();
+	}
+	check("SW_TIMER_MAX_TICKS timeout",
+			(fired_max - t_start) == SW_TIMER_MAX_TICKS);
+	check("timeout from level 4",
+			(fired_mid - t_start) == ((1U << (SW_TIMER_BITS * 4U)) + 5U));
+
+	printf("sw_timer_test: %s\n", (n_errors != 0U) ? "FAILED" : "passed");
+	return (n_errors != 0U) ? 1 : 0;
+}
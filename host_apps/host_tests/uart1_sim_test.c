@@ -0,0 +1,721 @@
+/******************************************************************************
+ * @Title		:	Host Test: UART1 Driver on Simulated FIFOs
+ * @Filename	:	uart1_sim_test.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	17/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	gcc (host, bsp/ headers)
+ * @Target		: 	PC (Linux)
+ * @Platform	: 	-
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+/* Runs uart/ps7_uart1_if.c, with the frame codec and the command handler,
+ * on a model of the UART1 FIFOs (bsp/xil_host_bsp.h):
+ *   - RX FIFO (64 bytes): bytes from the host "wire"; the ISR is called at
+ *     the trigger level set by the driver, and on a line-idle timeout;
+ *   - TX FIFO (64 bytes): drained to the host wire; TXEMPTY calls the ISR
+ *     when enabled;
+ *   - the main loop calls uart1ServiceCommands().
+ * Each step of the simulation moves a set number of bytes in each
+ * direction, so that runs at several RX/TX/main loop speed ratios cover a
+ * fast host, a slow transmitter (back-pressure on the transmit ring) and
+ * a slow main loop.
+ * The host sends back-to-back, variable-length requests (WRITE_WORD and
+ * READ_WORD pairs, with line noise between frames, then a 256-word
+ * WRITE_BLOCK and READ_BLOCK). Every response must come back once, in
+ * order, with the right tag, contents and CRC; the driver must never
+ * overflow a FIFO, nor call XUartPs_Send().
+ * Receive errors are then injected in the middle of frames: an overrun
+ * (bytes lost), a framing error and a parity error, each with its
+ * interrupt. Only the requests that overlap the bytes lost or flushed from
+ * the RX FIFO may be lost; every other request must be answered, without
+ * an assertion. GET_LINK_STATS must count each error class and the bytes
+ * flushed, and clear the counters.
+ * Returns 0 on success. */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "uart/ps7_uart1_if.h"
+
+
+#define SIM_FIFO_SIZE				64U
+#define SIM_WIRE_NBYTES				65536U
+#define SIM_MAX_STEPS				200000U
+#define SIM_IDLE_STEPS				2000U
+
+#define N_WORD_PAIRS				40U
+#define N_BLOCK_WORDS				256U
+
+#define N_FAULTS					3U
+
+#define TAG_WRITE_BLOCK				(2U * N_WORD_PAIRS)
+#define TAG_READ_BLOCK				(TAG_WRITE_BLOCK + 1U)
+#define N_REQUESTS					(TAG_READ_BLOCK + 1U)
+
+
+/* Simulation speeds: bytes per step on each side, main loop calls per step */
+typedef struct {
+	uint32_t rx_bytes;
+	uint32_t tx_bytes;
+	uint32_t main_calls;
+} sim_speed_t;
+
+static const sim_speed_t SimSpeeds[] = {
+	{  7U,  5U, 2U },		// Host slightly faster than the target transmits
+	{ 64U, 64U, 1U },		// Full FIFO each step
+	{  3U,  5U, 2U },		// Slow host
+	{ 40U,  3U, 2U },		// Slow transmitter: transmit ring fills
+	{ 64U,  8U, 1U },		// Fast host, slow transmitter, slow main loop
+	{  1U,  1U, 1U },		// One byte at a time
+};
+
+/* A receive error, injected when the wire reaches a byte of a request */
+typedef struct {
+	uint32_t tag;					// Request hit
+	uint32_t offset;				// Byte of the request frame
+	uint32_t n_lost;				// Bytes lost on the wire
+	uint32_t isr;					// Interrupt status bits
+	uint32_t event;					// Event passed to the handler
+	uint32_t wire_pos;				// Set by the test: position on the wire
+	uint32_t n_flushed;				// Set by the test: bytes in the RX FIFO
+	uint32_t done;
+} sim_fault_t;
+
+static sim_fault_t Faults[N_FAULTS] = {
+	{  6U, 7U, 5U, XUARTPS_IXR_OVER,    XUARTPS_EVENT_RECV_ORERR,      0U, 0U, 0U },
+	{ 30U, 3U, 1U, XUARTPS_IXR_FRAMING, XUARTPS_EVENT_PARE_FRAME_BRKE, 0U, 0U, 0U },
+	{ 51U, 12U, 1U, XUARTPS_IXR_PARITY, XUARTPS_EVENT_RECV_ERROR,      0U, 0U, 0U },
+};
+
+
+/* UART model */
+static uint8_t			RxFifo[SIM_FIFO_SIZE];
+static uint32_t			rx_fifo_rd = 0U;
+static uint32_t			rx_fifo_n = 0U;
+static uint32_t			tx_fifo_n = 0U;
+static uint32_t			uart_imr = 0U;
+static uint32_t			uart_isr = 0U;
+static uint32_t			rx_trigger = SIM_FIFO_SIZE;
+static XUartPs_Config	UartConfig;
+static XUartPs_Handler	p_UartHandler = NULL;
+static void				*p_UartCallBackRef = NULL;
+
+/* Host wire: requests sent, responses received */
+static uint8_t			WireIn[SIM_WIRE_NBYTES];
+static uint32_t			wire_in_n = 0U;
+static uint32_t			wire_in_rd = 0U;
+static uint8_t			WireOut[SIM_WIRE_NBYTES];
+static uint32_t			wire_out_n = 0U;
+
+/* Faults of the driver */
+static uint32_t			n_send_calls = 0U;
+static uint32_t			n_tx_overflows = 0U;
+static uint32_t			n_rx_overruns = 0U;
+
+/* Requests: their position on the wire, and whether they were answered */
+static uint32_t			FrameStart[N_REQUESTS];
+static uint32_t			FrameEnd[N_REQUESTS];
+static uint8_t			Answered[N_REQUESTS];
+
+/* Receive errors to inject in this run (NULL = none) */
+static sim_fault_t		*p_SimFaults = NULL;
+static uint32_t			n_asserts = 0U;
+
+/* Target memory for the word and block commands */
+static uint32_t			Memory[2U * N_BLOCK_WORDS] __attribute__((aligned(4)));
+
+static XTime			sim_time = 0U;
+
+
+
+/* ----- Host versions of the BSP and board functions ----- */
+
+u32 hostUartReadReg(u32 BaseAddress, u32 RegOffset)
+{
+	uint32_t value = 0U;
+
+	(void)BaseAddress;
+
+	if (RegOffset == XUARTPS_FIFO_OFFSET)
+	{
+		if (rx_fifo_n != 0U)
+		{
+			value = RxFifo[rx_fifo_rd];
+			rx_fifo_rd = (rx_fifo_rd + 1U) % SIM_FIFO_SIZE;
+			rx_fifo_n--;
+		}
+	}
+	else if (RegOffset == XUARTPS_SR_OFFSET)
+	{
+		value = ((rx_fifo_n == 0U) ? XUARTPS_SR_RXEMPTY : 0U)
+				| ((tx_fifo_n == 0U) ? XUARTPS_SR_TXEMPTY : XUARTPS_SR_TACTIVE)
+				| ((tx_fifo_n >= SIM_FIFO_SIZE) ? XUARTPS_SR_TXFULL : 0U);
+	}
+	else if (RegOffset == XUARTPS_ISR_OFFSET)
+	{
+		value = uart_isr;
+	}
+	else if (RegOffset == XUARTPS_IMR_OFFSET)
+	{
+		value = uart_imr;
+	}
+
+	return value;
+}
+
+
+void hostUartWriteReg(u32 BaseAddress, u32 RegOffset, u32 RegisterValue)
+{
+	(void)BaseAddress;
+
+	if (RegOffset == XUARTPS_FIFO_OFFSET)
+	{
+		if (tx_fifo_n >= SIM_FIFO_SIZE)
+		{
+			n_tx_overflows++;
+		}
+		else
+		{
+			WireOut[wire_out_n % SIM_WIRE_NBYTES] = (uint8_t)RegisterValue;
+			wire_out_n++;
+			tx_fifo_n++;
+		}
+	}
+	else if (RegOffset == XUARTPS_IER_OFFSET)
+	{
+		uart_imr |= RegisterValue;
+	}
+	else if (RegOffset == XUARTPS_IDR_OFFSET)
+	{
+		uart_imr &= ~RegisterValue;
+	}
+	else if (RegOffset == XUARTPS_ISR_OFFSET)
+	{
+		uart_isr &= ~RegisterValue;
+	}
+}
+
+
+XUartPs_Config *XUartPs_LookupConfig(u16 DeviceId)
+{
+	UartConfig.DeviceId = DeviceId;
+	return &UartConfig;
+}
+
+s32 XUartPs_CfgInitialize(XUartPs *InstancePtr, XUartPs_Config *Config, u32 EffectiveAddr)
+{
+	InstancePtr->Config = *Config;
+	InstancePtr->Config.BaseAddress = EffectiveAddr;
+	InstancePtr->IsReady = 1U;
+	return XST_SUCCESS;
+}
+
+s32 XUartPs_SelfTest(XUartPs *InstancePtr)
+{
+	(void)InstancePtr;
+	return XST_SUCCESS;
+}
+
+u32 XUartPs_Send(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes)
+{
+	(void)InstancePtr;
+	(void)BufferPtr;
+	n_send_calls++;
+	return NumBytes;
+}
+
+void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr, void *CallBackRef)
+{
+	(void)InstancePtr;
+	p_UartHandler = FuncPtr;
+	p_UartCallBackRef = CallBackRef;
+}
+
+void XUartPs_SetInterruptMask(XUartPs *InstancePtr, u32 Mask)
+{
+	(void)InstancePtr;
+	uart_imr = Mask;
+}
+
+void XUartPs_SetFifoThreshold(XUartPs *InstancePtr, u8 TriggerLevel)
+{
+	(void)InstancePtr;
+	rx_trigger = TriggerLevel;
+}
+
+void XUartPs_SetRecvTimeout(XUartPs *InstancePtr, u8 RecvTimeout)
+{
+	(void)InstancePtr;
+	(void)RecvTimeout;
+}
+
+void XUartPs_SetOperMode(XUartPs *InstancePtr, u8 OperationMode)
+{
+	(void)InstancePtr;
+	(void)OperationMode;
+}
+
+s32 XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate)
+{
+	InstancePtr->BaudRate = BaudRate;
+	return XST_SUCCESS;
+}
+
+void XTime_GetTime(XTime *Xtime_Global)
+{
+	sim_time += 50U;
+	*Xtime_Global = sim_time;
+}
+
+void Xil_ExceptionEnable(void)
+{
+}
+
+void Xil_ExceptionDisable(void)
+{
+}
+
+void psGpOutSet(PsGpio_OutPin_t pin)
+{
+	(void)pin;
+}
+
+void psGpOutClear(PsGpio_OutPin_t pin)
+{
+	(void)pin;
+}
+
+/* Shared variable test of tasks.c (called by the RX interrupt) */
+void hostAssert(const char *p_file, int line)
+{
+	printf("    assertion: %s, line %d\n", p_file, line);
+	n_asserts++;
+}
+
+void setTask1SharedVariable(uint32_t value);
+void setTask2SharedVariable(uint32_t value);
+
+void setTask1SharedVariable(uint32_t value)
+{
+	(void)value;
+}
+
+void setTask2SharedVariable(uint32_t value)
+{
+	(void)value;
+}
+
+
+
+/* ----- Simulation ----- */
+
+/* A receive error: the bytes are lost, and the error interrupt raised */
+static void simFault(sim_fault_t *p_fault)
+{
+	p_fault->n_flushed = rx_fifo_n;
+	p_fault->done = 1U;
+	wire_in_rd += p_fault->n_lost;
+
+	uart_isr |= p_fault->isr;
+	p_UartHandler(p_UartCallBackRef, p_fault->event, p_fault->isr);
+	uart_isr &= ~p_fault->isr;
+}
+
+
+/* One step: wire -> RX FIFO (ISR at the trigger level, or when the line
+ * goes idle), TX FIFO -> wire (ISR on TXEMPTY), then the main loop */
+static void simStep(const sim_speed_t *p_speed)
+{
+	uint32_t n_rx = 0U;
+	uint32_t k;
+
+	while ((n_rx < p_speed->rx_bytes) && (wire_in_rd < wire_in_n))
+	{
+		for (k = 0U; (p_SimFaults != NULL) && (k < N_FAULTS); k++)
+		{
+			if ((p_SimFaults[k].done == 0U) && (p_SimFaults[k].wire_pos == wire_in_rd))
+			{
+				simFault(&p_SimFaults[k]);
+			}
+		}
+		if (wire_in_rd >= wire_in_n)
+		{
+			break;
+		}
+
+		if (rx_fifo_n >= SIM_FIFO_SIZE)
+		{
+			n_rx_overruns++;
+		}
+		else
+		{
+			RxFifo[(rx_fifo_rd + rx_fifo_n) % SIM_FIFO_SIZE] = WireIn[wire_in_rd];
+			rx_fifo_n++;
+		}
+		wire_in_rd++;
+		n_rx++;
+
+		if ((rx_fifo_n >= rx_trigger) && ((uart_imr & XUARTPS_IXR_RXOVR) != 0U))
+		{
+			p_UartHandler(p_UartCallBackRef, XUARTPS_EVENT_RECV_DATA, rx_fifo_n);
+		}
+	}
+
+	/* Nothing received in this step: RX timeout */
+	if ((n_rx == 0U) && (rx_fifo_n != 0U) && ((uart_imr & XUARTPS_IXR_TOUT) != 0U))
+	{
+		uart_isr |= XUARTPS_IXR_TOUT;
+		p_UartHandler(p_UartCallBackRef, XUARTPS_EVENT_RECV_TOUT, rx_fifo_n);
+		uart_isr &= ~XUARTPS_IXR_TOUT;
+	}
+
+	tx_fifo_n -= (tx_fifo_n < p_speed->tx_bytes) ? tx_fifo_n : p_speed->tx_bytes;
+	if ((tx_fifo_n == 0U) && ((uart_imr & XUARTPS_IXR_TXEMPTY) != 0U))
+	{
+		/* As the Xilinx driver: TXEMPTY is disabled before the handler */
+		uart_imr &= ~XUARTPS_IXR_TXEMPTY;
+		p_UartHandler(p_UartCallBackRef, XUARTPS_EVENT_SENT_DATA, 0U);
+	}
+
+	for (k = 0U; k < p_speed->main_calls; k++)
+	{
+		(void)uart1ServiceCommands();
+	}
+}
+
+
+static void putWord(uint8_t *p_bytes, uint32_t word)
+{
+	p_bytes[0] = (uint8_t)(word >> 24);
+	p_bytes[1] = (uint8_t)(word >> 16);
+	p_bytes[2] = (uint8_t)(word >> 8);
+	p_bytes[3] = (uint8_t)word;
+}
+
+
+static uint32_t getWord(const uint8_t *p_bytes)
+{
+	return (((uint32_t)p_bytes[0] << 24) | ((uint32_t)p_bytes[1] << 16)
+			| ((uint32_t)p_bytes[2] << 8) | (uint32_t)p_bytes[3]);
+}
+
+
+/* Host: a command frame (and payload) to the wire, framed with a tag */
+static void hostSend(uint8_t tag, uint16_t cmd, uint32_t field1, uint32_t field2,
+						const uint8_t *p_payload, uint32_t n_payload)
+{
+	static uint8_t frame[FRAME_MAX_NBYTES];
+	uint8_t *p_cmd = frame + FRAME_HEADER_NBYTES;
+	uint32_t n_frame;
+
+	p_cmd[0] = (uint8_t)(cmd >> 8);
+	p_cmd[1] = (uint8_t)cmd;
+	putWord(p_cmd + 2U, field1);
+	putWord(p_cmd + 6U, field2);
+	if (n_payload != 0U)
+	{
+		memcpy(p_cmd + CMD_FRAME_NBYTES, p_payload, n_payload);
+	}
+
+	n_frame = frameEncode(frame, CMD_FRAME_NBYTES + n_payload, tag);
+	memcpy(WireIn + wire_in_n, frame, n_frame);
+	FrameStart[tag] = wire_in_n;
+	wire_in_n += n_frame;
+	FrameEnd[tag] = wire_in_n;
+}
+
+
+/* Host: the requests of one run */
+static void hostQueueRequests(void)
+{
+	static uint8_t payload[(N_BLOCK_WORDS + 1U) * 4U];
+	uint32_t base = (uint32_t)(uintptr_t)Memory;
+	uint32_t checksum = 0U;
+	uint32_t word;
+	uint32_t idx;
+
+	for (idx = 0U; idx < N_WORD_PAIRS; idx++)
+	{
+		hostSend((uint8_t)(2U * idx), WRITE_WORD, base + (4U * idx), 0x1000U + idx, NULL, 0U);
+
+		/* Line noise between frames: a stray SOF and a byte */
+		if (idx == 10U)
+		{
+			WireIn[wire_in_n++] = FRAME_SOF;
+			WireIn[wire_in_n++] = 0x00U;
+		}
+
+		hostSend((uint8_t)((2U * idx) + 1U), READ_WORD, base + (4U * idx), 0U, NULL, 0U);
+	}
+
+	for (idx = 0U; idx < N_BLOCK_WORDS; idx++)
+	{
+		word = idx * 0x01010101U;
+		putWord(payload + (4U * idx), word);
+		checksum += word;
+	}
+	putWord(payload + (4U * N_BLOCK_WORDS), checksum);
+
+	hostSend(TAG_WRITE_BLOCK, WRITE_BLOCK, base + (4U * N_BLOCK_WORDS), N_BLOCK_WORDS,
+				payload, sizeof(payload));
+	hostSend(TAG_READ_BLOCK, READ_BLOCK, base + (4U * N_BLOCK_WORDS), N_BLOCK_WORDS, NULL, 0U);
+}
+
+
+/* Host: checks the responses of one run (a request may be lost, but the
+ * responses must stay in order); returns the number received */
+static uint32_t hostCheckResponses(uint32_t *p_errors)
+{
+	uint32_t pos = 0U;
+	uint32_t n_responses = 0U;
+	uint32_t next_tag = 0U;
+	uint32_t len;
+	uint32_t tag;
+	uint32_t idx;
+	const uint8_t *p_payload;
+
+	while (pos < wire_out_n)
+	{
+		if ((WireOut[pos] != FRAME_SOF) || ((pos + FRAME_HEADER_NBYTES) > wire_out_n))
+		{
+			printf("    byte %u: no SOF\n", pos);
+			(*p_errors)++;
+			break;
+		}
+
+		len = ((uint32_t)WireOut[pos + 1U] << 8) | WireOut[pos + 2U];
+		tag = WireOut[pos + 3U];
+		p_payload = WireOut + pos + FRAME_HEADER_NBYTES;
+
+		if (crc16Ccitt(0xFFFFU, WireOut + pos + 1U, 3U + len)
+				!= (((uint32_t)p_payload[len] << 8) | p_payload[len + 1U]))
+		{
+			printf("    tag %u: bad CRC\n", tag);
+			(*p_errors)++;
+		}
+
+		if ((tag < next_tag) || (tag >= N_REQUESTS))
+		{
+			printf("    tag %u: expected tag %u or later\n", tag, next_tag);
+			(*p_errors)++;
+		}
+		else if ((tag < TAG_WRITE_BLOCK) && ((tag & 1U) == 0U))
+		{
+			*p_errors += (getWord(p_payload) != WRITE_OKAY) ? 1U : 0U;
+		}
+		else if (tag < TAG_WRITE_BLOCK)
+		{
+			/* The word is written, unless its WRITE_WORD was lost */
+			*p_errors += (getWord(p_payload) != ((Answered[tag - 1U] != 0U) ? (0x1000U + (tag / 2U)) : 0U)) ? 1U : 0U;
+		}
+		else if (tag == TAG_WRITE_BLOCK)
+		{
+			*p_errors += (getWord(p_payload) != WRITE_OKAY) ? 1U : 0U;
+		}
+		else
+		{
+			*p_errors += (len != ((N_BLOCK_WORDS + 1U) * 4U)) ? 1U : 0U;
+			for (idx = 0U; (idx < N_BLOCK_WORDS) && (len == ((N_BLOCK_WORDS + 1U) * 4U)); idx++)
+			{
+				if (getWord(p_payload + (4U * idx)) != (idx * 0x01010101U))
+				{
+					(*p_errors)++;
+					break;
+				}
+			}
+		}
+
+		if (tag < N_REQUESTS)
+		{
+			Answered[tag] = 1U;
+		}
+		next_tag = tag + 1U;
+		n_responses++;
+		pos += FRAME_HEADER_NBYTES + len + FRAME_CRC_NBYTES;
+	}
+
+	return n_responses;
+}
+
+
+/* One run at one speed ratio, with or without receive errors; returns 1
+ * if every request was answered, except those hit by an error */
+static int simRun(const sim_speed_t *p_speed, sim_fault_t *p_faults)
+{
+	uint32_t n_errors = 0U;
+	uint32_t n_responses;
+	uint32_t n_expected = N_REQUESTS;
+	uint32_t step;
+	uint32_t idle = 0U;
+	uint32_t n_out;
+	uint32_t tag;
+	uint32_t lost;
+	uint32_t k;
+
+	wire_in_n = 0U;
+	wire_in_rd = 0U;
+	wire_out_n = 0U;
+	memset(Memory, 0, sizeof(Memory));
+	memset(Answered, 0, sizeof(Answered));
+
+	hostQueueRequests();
+
+	p_SimFaults = p_faults;
+	for (k = 0U; (p_faults != NULL) && (k < N_FAULTS); k++)
+	{
+		p_faults[k].wire_pos = FrameStart[p_faults[k].tag] + p_faults[k].offset;
+		p_faults[k].n_flushed = 0U;
+		p_faults[k].done = 0U;
+	}
+
+	/* Until the host has sent everything and the target has been quiet
+	 * for a while */
+	for (step = 0U; (step < SIM_MAX_STEPS) && (idle < SIM_IDLE_STEPS); step++)
+	{
+		n_out = wire_out_n;
+		simStep(p_speed);
+		idle = ((wire_in_rd == wire_in_n) && (wire_out_n == n_out) && (tx_fifo_n == 0U))
+				? (idle + 1U) : 0U;
+	}
+
+	n_responses = hostCheckResponses(&n_errors);
+	p_SimFaults = NULL;
+
+	/* A request is lost if, and only if, it overlaps the bytes lost on the
+	 * wire or flushed from the RX FIFO */
+	for (tag = 0U; tag < N_REQUESTS; tag++)
+	{
+		lost = 0U;
+		for (k = 0U; (p_faults != NULL) && (k < N_FAULTS); k++)
+		{
+			if ( (FrameEnd[tag] > (p_faults[k].wire_pos - p_faults[k].n_flushed))
+					&& (FrameStart[tag] < (p_faults[k].wire_pos + p_faults[k].n_lost)) )
+			{
+				lost = 1U;
+			}
+		}
+
+		n_expected -= lost;
+		if (Answered[tag] == lost)
+		{
+			printf("    tag %u: %s\n", tag, (lost != 0U) ? "answered, but hit by an error" : "not answered");
+			n_errors++;
+		}
+	}
+
+	printf("  RX %2u, TX %2u bytes/step, main loop x%u%s: %u responses (of %u), %u errors\n",
+			p_speed->rx_bytes, p_speed->tx_bytes, p_speed->main_calls,
+			(p_faults != NULL) ? ", receive errors" : "", n_responses, n_expected, n_errors);
+
+	return ((n_responses == n_expected) && (n_errors == 0U)) ? 1 : 0;
+}
+
+
+/* GET_LINK_STATS, as sent by the host */
+static uint32_t getLinkStats(uint32_t selector)
+{
+	uint8_t rx_buffer[CMD_FRAME_NBYTES];
+	uint8_t tx_buffer[CMD_MAX_RESPONSE_NBYTES];
+
+	rx_buffer[0] = (uint8_t)(GET_LINK_STATS >> 8);
+	rx_buffer[1] = (uint8_t)GET_LINK_STATS;
+	putWord(rx_buffer + 2U, selector);
+	putWord(rx_buffer + 6U, 0U);
+	(void)handleCommand(rx_buffer, tx_buffer, 0U);
+
+	return getWord(tx_buffer);
+}
+
+
+static int check(const char *p_name, int ok)
+{
+	printf("  %-52s %s\n", p_name, (ok != 0) ? "ok" : "FAILED");
+	return (ok != 0) ? 0 : 1;
+}
+
+
+int main(void)
+{
+	uint32_t inst;
+	uint32_t idx;
+	uint32_t k;
+	uint32_t n_runs = 0U;
+	uint32_t n_flushed = 0U;
+	int ok = 1;
+	int failed = 0;
+
+	(void)cmdHandlerInit();
+	(void)cmdRegisterCommands();
+	(void)frameRegisterCommands();
+	(void)uart1RegisterCommands();
+	setCommandResponder(uart1QueueResponse);
+	(void)xUart1PsInit(&inst);
+
+	for (idx = 0U; idx < (sizeof(SimSpeeds) / sizeof(SimSpeeds[0])); idx++)
+	{
+		if (simRun(&SimSpeeds[idx], NULL) == 0)
+		{
+			ok = 0;
+		}
+	}
+
+	failed |= check("back-to-back requests at every speed ratio", ok);
+	failed |= check("no receive error counted",
+					(getLinkStats(UART_LINK_STATS_OVERRUN) == 0U)
+					&& (getLinkStats(UART_LINK_STATS_RESYNCS) == 0U));
+
+	/* Receive errors, at a fast, a mid and the slowest ratio */
+	ok = 1;
+	for (idx = 0U; idx < (sizeof(SimSpeeds) / sizeof(SimSpeeds[0])); idx += 2U)
+	{
+		if (simRun(&SimSpeeds[idx], Faults) == 0)
+		{
+			ok = 0;
+		}
+		for (k = 0U; k < N_FAULTS; k++)
+		{
+			n_flushed += Faults[k].n_flushed;
+		}
+		n_runs++;
+	}
+
+	failed |= check("receive errors: only the requests hit are lost", ok);
+	failed |= check("receive errors: no assertion", n_asserts == 0U);
+	failed |= check("GET_LINK_STATS: overrun, framing, parity, flushed",
+					(getLinkStats(UART_LINK_STATS_OVERRUN) == n_runs)
+					&& (getLinkStats(UART_LINK_STATS_FRAMING) == n_runs)
+					&& (getLinkStats(UART_LINK_STATS_PARITY) == n_runs)
+					&& (getLinkStats(UART_LINK_STATS_FLUSHED) == n_flushed));
+	failed |= check("GET_LINK_STATS: one resync per error",
+					getLinkStats(UART_LINK_STATS_RESYNCS) == (n_runs * N_FAULTS));
+	failed |= check("GET_LINK_STATS: clear",
+					(getLinkStats(UART_LINK_STATS_CLEAR) == WRITE_OKAY)
+					&& (getLinkStats(UART_LINK_STATS_OVERRUN) == 0U)
+					&& (getLinkStats(UART_LINK_STATS_FLUSHED) == 0U)
+					&& (getLinkStats(UART_LINK_STATS_RESYNCS) == 0U));
+	failed |= check("RX FIFO drained in time, TX FIFO never overfilled",
+					(n_rx_overruns == 0U) && (n_tx_overflows == 0U));
+	failed |= check("XUartPs_Send() never called", n_send_calls == 0U);
+
+	printf("uart1_sim_test: %s\n", (failed != 0) ? "FAILED" : "passed");
+	return failed;
+}
@@ -0,0 +1,87 @@
+#------------------------------------------------------------#
+# Host decoder for the target's deferred log (see logger.h).
+#
+# The target sends each log record as raw words:
+#   ID (2) | N | SEQ | TIME HI | TIME LO | ARG 0 | ... | ARG N-1
+# packed into unsolicited frames with TAG = FRAME_TAG_LOG.
+# The format strings are not on the target: they are read here
+# from log_messages.h, the same table the firmware is built
+# from, so IDs match as long as both use the same file.
+#------------------------------------------------------------#
+import re
+from struct import unpack
+
+LOG_HEADER_WORDS = 3
+COUNTS_PER_SECOND = 333333333   # Global Timer: CPU clock / 2
+
+LOG_ENTRY_RE = re.compile(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+LOG_COMMENT_RE = re.compile(r'/\*.*?\*/|//[^\n]*', re.S)
+LOG_SPEC_RE = re.compile(r'%[-+ 0#]*\d*(?:\.\d+)?([diuxXoc%])')
+
+
+#------------------------------------------------------------#
+# Read the message table from log_messages.h.
+# Returns a list of (name, format), indexed by message ID.
+#------------------------------------------------------------#
+def load_log_messages(path):
+    with open(path) as f:
+        text = LOG_COMMENT_RE.sub('', f.read())
+    return [(name, bytes(fmt, 'ascii').decode('unicode_escape'))
+            for (name, fmt) in LOG_ENTRY_RE.findall(text)]
+
+
+#------------------------------------------------------------#
+# Format one record: %d/%i arguments are signed 32-bit values,
+# all others unsigned.
+#------------------------------------------------------------#
+def format_log_message(fmt, args):
+    values = []
+    specs = [s for s in LOG_SPEC_RE.findall(fmt) if s != '%']
+    for (spec, arg) in zip(specs, args):
+        if spec in 'di' and arg & 0x80000000:
+            arg = arg - 0x100000000
+        values.append(arg)
+    if len(values) != len(specs):
+        return fmt + ' ' + str(args)
+    return fmt % tuple(values)
+
+
+class LogDecoder:
+    def __init__(self, messages_path, counts_per_second=COUNTS_PER_SECOND):
+        self.messages = load_log_messages(messages_path)
+        self.counts_per_second = counts_per_second
+        self.last_seq = None
+        self.lost = 0
+
+    #--------------------------------------------------------#
+    # Decode the payload of one log frame. Returns a list of
+    # dicts: id, name, seq, time (s), args, text. Gaps in SEQ
+    # (records dropped on the target) are added to self.lost.
+    #--------------------------------------------------------#
+    def decode(self, payload):
+        words = list(unpack('>{}L'.format(len(payload) // 4), payload))
+        records = []
+        i = 0
+        while i + LOG_HEADER_WORDS <= len(words):
+            header = words[i]
+            msg_id = header >> 16
+            n_args = (header >> 8) & 0xFF
+            seq = header & 0xFF
+            time_counts = (words[i + 1] << 32) | words[i + 2]
+            args = words[i + LOG_HEADER_WORDS:i + LOG_HEADER_WORDS + n_args]
+            i = i + LOG_HEADER_WORDS + n_args
+
+            if self.last_seq is not None:
+                self.lost = self.lost + ((seq - self.last_seq - 1) & 0xFF)
+            self.last_seq = seq
+
+            if msg_id < len(self.messages):
+                (name, fmt) = self.messages[msg_id]
+                text = format_log_message(fmt, args)
+            else:
+                (name, text) = ('?', 'unknown message ID {} {}'.format(msg_id, args))
+
+            records.append({'id': msg_id, 'name': name, 'seq': seq,
+                            'time': time_counts / self.counts_per_second,
+                            'args': args, 'text': text})
+        return records
@@ -56,10 +56,18 @@
  * 				(4) PS7 GPIO.
  * 				(5) TTC0
  * 				(6) UART1
+ * 				(7) Command handler (registry and module commands)
+ * 				(8) Scheduler (task table)
  *
  * 				Adds the following to the interrupt system:
  * 				(1) TTC0
  * 				(2) UART1
+ * 				(3) Scheduler SGIs (preemptive tasks)
+ *
+ * 				AMP build (see amp.h): this is CPU0. UART1 and the frame
+ * 				layer are left to CPU1; the shared block is set up, the
+ * 				doorbell is added to the interrupt system, and CPU1 is
+ * 				started.
  *
  * 				Function runs all the way to the end (unless an assertion is
  * 				triggered in one of the device init routines), and then checks if
@@ -75,6 +83,8 @@
  *
 ******************************************************************************/
 
+#if !AMP_COMMS_IMAGE
+
 int sys_init(void){
 
 
@@ -98,7 +108,9 @@ int sys_init(void){
 	 * pointer to its instance. The pointer will be passed to the relevant
 	 * add_DEVICE_ToInterruptSystem(*p_inst) function */
 	uint32_t p_xttc0_inst;
+#if !AMP_MODE
 	uint32_t p_uart1_inst;
+#endif
 
 
 
@@ -129,7 +141,41 @@ int sys_init(void){
 	/* For devices which will be added to interrupt system,
 	 we must get a reference to the instance pointer(s): */
 	p_InitStatus->xttc0 = xTtc0Init(&p_xttc0_inst);	// TTC0
+#if AMP_MODE
+	p_InitStatus->uart1 = XST_SUCCESS;					// UART1: CPU1
+#else
 	p_InitStatus->uart1 = xUart1PsInit(&p_uart1_inst);	// UART1
+#endif
+
+	/* Command handler: core commands, then commands owned by other modules */
+	p_InitStatus->cmd_handler = cmdHandlerInit();
+	p_InitStatus->cmd_handler |= cmdRegisterCommands();
+	p_InitStatus->cmd_handler |= axiGpio0RegisterCommands();
+#if !AMP_MODE
+	p_InitStatus->cmd_handler |= frameRegisterCommands();
+	p_InitStatus->cmd_handler |= uart1RegisterCommands();
+#endif
+	p_InitStatus->cmd_handler |= ttc0RegisterCommands();
+	p_InitStatus->cmd_handler |= seqRegisterCommands();
+	p_InitStatus->cmd_handler |= telemRegisterCommands();
+	p_InitStatus->cmd_handler |= logRegisterCommands();
+#if AMP_MODE
+	setCommandResponder(ampSendFrame);			// Deferred responses, through CPU1
+#else
+	setCommandResponder(uart1QueueResponse);	// Deferred responses (WAIT_FOR, telemetry, log)
+#endif
+
+	/* Scheduler: task table (see tasks.c), and idle mode */
+	p_InitStatus->scheduler = tasksInit();
+	p_InitStatus->scheduler |= schedRegisterCommands();
+	p_InitStatus->scheduler |= idleRegisterCommands();
+
+	/* AMP: shared block (before CPU1 is started) */
+#if AMP_MODE
+	p_InitStatus->amp = ampInit();
+#else
+	p_InitStatus->amp = XST_SUCCESS;
+#endif
 
 
 
@@ -139,7 +185,28 @@ int sys_init(void){
 	/*--------------------------------------------*/
 
 	p_addIntrStatus->xttc0 = addTtc0ToInterruptSystem(p_xttc0_inst);
+#if AMP_MODE
+	p_addIntrStatus->uart1 = XST_SUCCESS;
+	p_addIntrStatus->amp = addAmpToInterruptSystem();
+#else
 	p_addIntrStatus->uart1 = addUart1ToInterruptSystem(p_uart1_inst);
+	p_addIntrStatus->amp = XST_SUCCESS;
+#endif
+	p_addIntrStatus->sched = addSchedToInterruptSystem();
+
+
+	/* Log the results; the records are sent to the host once the main loop
+	 * is running (see logDrain()). */
+	LOG4(LOG_INIT_DRIVERS, p_InitStatus->xscu_gic, p_InitStatus->xscu_wdt,
+			p_InitStatus->xgpio0, p_InitStatus->xgpiops);
+	LOG3(LOG_INIT_COMMS, p_InitStatus->xttc0, p_InitStatus->uart1,
+			p_InitStatus->cmd_handler);
+	LOG3(LOG_INIT_INTR, p_addIntrStatus->xttc0, p_addIntrStatus->uart1,
+			p_addIntrStatus->sched);
+	LOG1(LOG_INIT_SCHEDULER, p_InitStatus->scheduler);
+#if AMP_MODE
+	LOG3(LOG_INIT_AMP, AMP_CPU, p_InitStatus->amp, p_addIntrStatus->amp);
+#endif
 
 
 #if SYS_CONFIG_DEBUG
@@ -164,7 +231,15 @@ int sys_init(void){
 	else											{ printf("Success.\n\r"); }
 
 	printf("UART1 initialization: ");
-	if (p_InitStatus->uart1 != XST_SUCCESS) 		{ printf("Error detected.\n\r\n\r"); }
+	if (p_InitStatus->uart1 != XST_SUCCESS) 		{ printf("Error detected.\n\r"); }
+	else											{ printf("Success.\n\r"); }
+
+	printf("Command handler initialization: ");
+	if (p_InitStatus->cmd_handler != XST_SUCCESS) 	{ printf("Error detected.\n\r"); }
+	else											{ printf("Success.\n\r"); }
+
+	printf("Scheduler initialization: ");
+	if (p_InitStatus->scheduler != XST_SUCCESS) 	{ printf("Error detected.\n\r\n\r"); }
 	else											{ printf("Success.\n\r\n\r"); }
 
 
@@ -174,9 +249,20 @@ int sys_init(void){
 	else											{ printf("Success.\n\r"); }
 
 	printf("Adding UART1 to interrupt system: ");
-	if (p_addIntrStatus->uart1 != XST_SUCCESS) 		{ printf("Error detected.\n\r\n\r"); }
+	if (p_addIntrStatus->uart1 != XST_SUCCESS) 		{ printf("Error detected.\n\r"); }
+	else											{ printf("Success.\n\r"); }
+
+	printf("Adding scheduler SGIs to interrupt system: ");
+	if (p_addIntrStatus->sched != XST_SUCCESS) 		{ printf("Error detected.\n\r\n\r"); }
 	else											{ printf("Success.\n\r\n\r"); }
 
+#if AMP_MODE
+	printf("AMP shared block / doorbell: ");
+	if ((p_InitStatus->amp != XST_SUCCESS) || (p_addIntrStatus->amp != XST_SUCCESS))
+													{ printf("Error detected.\n\r\n\r"); }
+	else											{ printf("Success.\n\r\n\r"); }
+#endif
+
 #endif
 
 
@@ -190,7 +276,10 @@ int sys_init(void){
     	&& 	(p_InitStatus->xgpio0 == XST_SUCCESS)			// AXI GPIO
     	&& 	(p_InitStatus->xgpiops == XST_SUCCESS)			// PS7 GPIO
 		&& 	(p_InitStatus->xttc0 == XST_SUCCESS) 			// TTC0
-		&& 	(p_InitStatus->uart1 == XST_SUCCESS) )			// UART1
+		&& 	(p_InitStatus->uart1 == XST_SUCCESS)			// UART1
+		&& 	(p_InitStatus->cmd_handler == XST_SUCCESS)		// CMD HANDLER
+		&& 	(p_InitStatus->scheduler == XST_SUCCESS)		// SCHEDULER
+		&& 	(p_InitStatus->amp == XST_SUCCESS) )			// AMP
     {
 		init_result = XST_SUCCESS;
     }
@@ -204,7 +293,9 @@ int sys_init(void){
 	int add_intr_result;
 
 	if ( (p_addIntrStatus->xttc0 == XST_SUCCESS)
-		&& (p_addIntrStatus->uart1 == XST_SUCCESS) )
+		&& (p_addIntrStatus->uart1 == XST_SUCCESS)
+		&& (p_addIntrStatus->sched == XST_SUCCESS)
+		&& (p_addIntrStatus->amp == XST_SUCCESS) )
 	{
 		add_intr_result = XST_SUCCESS;
     }
@@ -214,6 +305,15 @@ int sys_init(void){
     }
 
 
+#if AMP_MODE
+	/* Start the comms core once the shared block is set up */
+	if (p_InitStatus->amp == XST_SUCCESS)
+	{
+		ampStartCpu1();
+	}
+#endif
+
+
 	/* Check both results: */
 	if( (init_result == XST_SUCCESS) && (add_intr_result == XST_SUCCESS))
 	{
@@ -227,6 +327,106 @@ int sys_init(void){
 
 }
 
+#else
+
+/*****************************************************************************
+ * Function: sys_init() [AMP, CPU1]
+ *//**
+ *
+ * @brief		Initialises the comms core of the AMP build (see amp.h).
+ *
+ * @detail		Initialises the following:
+ * 				(1) Assertion handling.
+ * 				(2) SCU GIC (CPU interface only: the BSP is built with
+ * 				    USE_AMP=1, and CPU0 owns the distributor).
+ * 				(3) UART1
+ * 				(4) Command handler: the UART and frame commands. Every
+ * 				    other command is passed to CPU0 (ampCallCpu0()).
+ * 				(5) Shared block (waits for CPU0).
+ *
+ * 				Adds the following to the interrupt system:
+ * 				(1) UART1 (routed to this core)
+ * 				(2) Doorbell and tick SGIs
+ *
+ * @param[in]	None.
+ *
+ * @return		Returns result of configuration attempt:
+ * 				XIL_SUCCESS or XIL_FAILURE
+ *
+ * @note		CPU1 has no GPIO, timer or WDT of its own in this build.
+ *
+******************************************************************************/
+
+int sys_init(void){
+
+
+	init_status_t InitStatus;
+	init_status_t  *p_InitStatus = &InitStatus;
+
+	add_intr_status_t addIntrStatus;
+	add_intr_status_t *p_addIntrStatus = &addIntrStatus;
+
+	uint32_t p_uart1_inst;
+
+
+	/* Assertions */
+	Xil_AssertSetCallback((Xil_AssertCallback) AssertPrint);
+
+
+	/* Drivers */
+	p_InitStatus->xscu_gic = xScuGicInit();				// SCU GIC
+	p_InitStatus->uart1 = xUart1PsInit(&p_uart1_inst);	// UART1
+
+	/* Command handler: local commands; the rest run on CPU0 */
+	p_InitStatus->cmd_handler = cmdHandlerInit();
+	p_InitStatus->cmd_handler |= frameRegisterCommands();
+	p_InitStatus->cmd_handler |= uart1RegisterCommands();
+	setCommandResponder(uart1QueueResponse);
+	setCommandRemote(ampCallCpu0);
+
+	/* Shared block, set up by CPU0 */
+	p_InitStatus->amp = ampInit();
+
+
+	/* Interrupt system */
+	p_addIntrStatus->uart1 = addUart1ToInterruptSystem(p_uart1_inst);
+	p_addIntrStatus->amp = addAmpToInterruptSystem();
+
+
+	/* Log the results (sent to the host by this core; no TTC0 here) */
+	LOG3(LOG_INIT_COMMS, XST_SUCCESS, p_InitStatus->uart1, p_InitStatus->cmd_handler);
+	LOG3(LOG_INIT_AMP, AMP_CPU, p_InitStatus->amp, p_addIntrStatus->amp);
+
+
+#if SYS_CONFIG_DEBUG
+	printf("CPU1 (AMP comms core) initialization: ");
+	if ((p_InitStatus->xscu_gic != XST_SUCCESS) || (p_InitStatus->uart1 != XST_SUCCESS)
+			|| (p_InitStatus->cmd_handler != XST_SUCCESS) || (p_InitStatus->amp != XST_SUCCESS)
+			|| (p_addIntrStatus->uart1 != XST_SUCCESS) || (p_addIntrStatus->amp != XST_SUCCESS))
+													{ printf("Error detected.\n\r\n\r"); }
+	else											{ printf("Success.\n\r\n\r"); }
+#endif
+
+
+	if (	(p_InitStatus->xscu_gic == XST_SUCCESS)
+		&& 	(p_InitStatus->uart1 == XST_SUCCESS)
+		&& 	(p_InitStatus->cmd_handler == XST_SUCCESS)
+		&& 	(p_InitStatus->amp == XST_SUCCESS)
+		&& 	(p_addIntrStatus->uart1 == XST_SUCCESS)
+		&& 	(p_addIntrStatus->amp == XST_SUCCESS) )
+	{
+		return XST_SUCCESS;
+	}
+	else
+	{
+		return XST_FAILURE;
+	}
+
+
+}
+
+#endif /* AMP_COMMS_IMAGE */
+
 
 
 
@@ -237,7 +437,8 @@ int sys_init(void){
  * @brief		This is the callback function to be invoked when an assert
  * 				occurs.
  *
- * @details		The function prints out the file and line number where the
+ * @details		The function logs the line number and the address of the file
+ * 				name, and prints out the file and line number where the
  * 				assertion has occurred, assuming a terminal/console is
  * 				connected to the test platform. It is used with the function
  * 				Xil_AssertSetCallback()  (see xil_assert.c).
@@ -249,12 +450,15 @@ int sys_init(void){
  * @return		None.
  *
  * @note		A stdout terminal or other UART host program must be connected
- * 				to see the output!
+ * 				to see the output! The main loop does not run after an
+ * 				assertion, so the log record is not sent to the host; it can
+ * 				be read from the log ring with XSCT.
  *
 ******************************************************************************/
 
 void AssertPrint(const char8 *file, s32 line)
 {
+	LOG2(LOG_ASSERT, file, line);
 	xil_printf("\r\nAssertion in file %s on line %d\r\n", file, line);
 }
 
@@ -45,6 +45,17 @@
 #include "wdt/scuwdt_if.h"
 #include "timers/ttc0_if.h"
 #include "uart/ps7_uart1_if.h"
+#include "utilities/cmd_handler.h"
+#include "utilities/frame_codec.h"
+#include "utilities/wait_for.h"
+#include "utilities/sequencer.h"
+#include "utilities/telemetry.h"
+#include "utilities/logger.h"
+#include "utilities/scheduler.h"
+#include "utilities/idle.h"
+#include "utilities/sw_timer.h"
+#include "amp/amp.h"
+#include "tasks.h"
 
 
 /*****************************************************************************/
@@ -58,9 +69,6 @@
 /* Toggle rate for LED0 if initialisation fails */
 #define INIT_FAIL_LOOP_DELAY		10000000U
 
-/* Slow down LED9 toggle rate, when loop rate is very fast */
-#define LED9_TOGGLE_COUNT			8000U
-
 
 /*****************************************************************************/
 /******************************* Typedefs ************************************/
@@ -74,6 +82,9 @@ typedef struct {
 	volatile int xscu_gic;
 	volatile int xttc0;
 	volatile int uart1;
+	volatile int cmd_handler;
+	volatile int scheduler;
+	volatile int amp;
 }init_status_t;
 
 
@@ -81,6 +92,8 @@ typedef struct {
 typedef struct {
 	volatile int xttc0;
 	volatile int uart1;
+	volatile int sched;
+	volatile int amp;
 }add_intr_status_t;
 
 
@@ -120,6 +133,8 @@ extern void enableInterrupts(void);
 extern void disableInterrupts(void);
 extern int addTtc0ToInterruptSystem(uint32_t p_XScuTimerInst);
 extern int addUart1ToInterruptSystem(uint32_t p_XUartPsInst);
+extern int addSchedToInterruptSystem(void);
+extern int addAmpToInterruptSystem(void);
 
 
 
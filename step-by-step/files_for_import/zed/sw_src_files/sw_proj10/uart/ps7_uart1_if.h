@@ -41,6 +41,18 @@
 // Added for nested interrupt support:
 #include "xil_exception.h"
 
+// Command handler interface (frame sizes, handleCommand()):
+#include "../utilities/cmd_handler.h"
+
+// Frame codec (SOF + LEN + CRC framing, byte-wise parser):
+#include "../utilities/frame_codec.h"
+
+// Deferred logger (receive errors, baud rate changes):
+#include "../utilities/logger.h"
+
+// Lock-free SPSC ring (receive ring):
+#include "../utilities/spsc_ring.h"
+
 
 
 /*****************************************************************************/
@@ -54,8 +66,93 @@
 
 
 /* Uart1 Settings */
-#define UART_RX_BUFFER_SIZE			10U		// 10 byte command frame from host
-#define UART_TX_BUFFER_SIZE			4U		// 4 byte response frame to host
+/* A framed response of the largest size (BATCH, READ_BLOCK). */
+#define UART_TX_MAX_FRAME_SIZE		(FRAME_HEADER_NBYTES + CMD_MAX_RESPONSE_NBYTES + FRAME_CRC_NBYTES)
+
+/* Receive ring: bytes from the RX FIFO, waiting to be parsed and executed
+ * by the main loop. Holds a window of 8 requests of the largest size
+ * (WRITE_BLOCK). Must be a power of 2. */
+#define UART_RX_RING_SIZE			16384U
+
+/* Receive errors waiting for the frame parser to reach their position in
+ * the receive ring (see handleRxError()). Must be a power of 2. */
+#define UART_RX_RESYNC_SLOTS		8U
+
+/* Transmit ring: framed responses waiting to be sent. Must be a power of 2,
+ * and at least UART_TX_MAX_FRAME_SIZE. */
+#define UART_TX_RING_SIZE			8192U
+
+/* RX FIFO trigger level. The ISR drains the FIFO into the receive ring
+ * whenever this many bytes are waiting... */
+#define UART_RX_FIFO_TRIGGER		32U
+
+/* ...or when the line has been idle for this time (units of 4 bit periods),
+ * so that the last bytes of a frame are collected without delay. */
+#define UART_RX_TIMEOUT				4U
+
+
+/* -------- Baud rate negotiation -------*/
+/*	1. The host sends SET_BAUD (Field 1 = new rate, Field 2 = timeout in
+*	   TTC0 cycles, 0 = UART_BAUD_VERIFY_TIMEOUT).
+*	2. The target responds WRITE_OKAY at the old rate (CMD_ERROR if the
+*	   rate is out of range or a change is already in progress). When the
+*	   response has left the transmitter, the target switches rate.
+*	3. The host switches rate, and sends BAUD_CONFIRM at the new rate.
+*	   The target keeps the new rate, and responds with it.
+*	4. If no BAUD_CONFIRM is received before the timeout (or the UART
+*	   cannot generate the rate within 3%), the target goes back to the
+*	   old rate. The host does the same when its BAUD_CONFIRM times out.
+*
+*	Bytes received while the rate is being changed are discarded. */
+
+#define UART_BAUD_DEFAULT			115200U
+#define UART_BAUD_VERIFY_TIMEOUT	20000U		// TTC0 cycles (1 s)
+
+/* Baud negotiation states */
+#define UART_BAUD_IDLE				0U
+#define UART_BAUD_PENDING			1U		// Acknowledged; waiting for TX to finish
+#define UART_BAUD_VERIFY			2U		// Switched; waiting for BAUD_CONFIRM
+
+
+/* Receive error interrupts. (A break is reported as a framing error.) */
+#define UART_RX_ERROR_MASK			(XUARTPS_IXR_OVER | XUARTPS_IXR_FRAMING | XUARTPS_IXR_PARITY)
+
+/* GET_LINK_STATS selectors (FIELD 1) */
+#define UART_LINK_STATS_OVERRUN		0U
+#define UART_LINK_STATS_FRAMING		1U
+#define UART_LINK_STATS_PARITY		2U
+#define UART_LINK_STATS_OTHER		3U
+#define UART_LINK_STATS_FLUSHED		4U
+#define UART_LINK_STATS_RESYNCS		5U
+#define UART_LINK_STATS_CLEAR		6U
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* Baud rate negotiation state */
+typedef struct {
+	uint32_t state;							// UART_BAUD_xxx
+	uint32_t rate;							// Current rate
+	uint32_t old_rate;						// Fallback rate
+	uint32_t new_rate;						// Requested rate
+	uint32_t timeout;						// VERIFY timeout, TTC0 cycles
+	uint32_t ticks_left;					// VERIFY: TTC0 cycles to fallback
+} uart_baud_t;
+
+/* Receive error counters. On a receive error the RX FIFO is flushed, and
+ * the frame parser is reset once the bytes received before the error have
+ * been parsed, so the link recovers without a reset. */
+typedef struct {
+	volatile uint32_t overrun;				// RX FIFO overrun
+	volatile uint32_t framing;				// Framing error or break
+	volatile uint32_t parity;				// Parity error
+	volatile uint32_t other;				// Unexpected events (modem status, etc.)
+	volatile uint32_t flushed;				// Bytes discarded from the RX FIFO
+	volatile uint32_t resyncs;				// Frame parser resets after an error
+} uart_link_stats_t;
+
 
 
 /****************************************************************************/
@@ -69,15 +166,19 @@ int xUart1PsInit(uint32_t *p_inst);
 /* Interrupt handler */
 void UartIntrHandler(void *CallBackRef, uint32_t event, uint32_t event_data);
 
+/* Deferred command execution; called from the main loop */
+uint32_t uart1ServiceCommands(void);
+uint32_t uart1WorkPending(void);
+int uart1QueueResponse(uint32_t request_id, uint8_t *response, uint32_t n_bytes);
 
-/* Defined in cmd_handler code */
-extern void handleCommand(uint8_t *rx_buffer, uint8_t *tx_buffer);
-
+/* Baud rate negotiation */
+int uart1RegisterCommands(void);
+void uart1BaudTick(void);
 
 
-/* Added sw_proj10 for access to shared variables in system_config.c */
-extern void setTask1SharedVariable(uint32_t value);
-extern void setTask2SharedVariable(uint32_t value);
+/* Defined in cmd_handler code */
+extern uint32_t getCommandPayloadSize(uint8_t *rx_buffer);
+extern uint32_t handleCommand(uint8_t *rx_buffer, uint8_t *tx_buffer, uint32_t request_id);
 
 
 
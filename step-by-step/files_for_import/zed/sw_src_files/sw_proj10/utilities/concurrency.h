@@ -0,0 +1,224 @@
+/******************************************************************************
+ * @Title		:	Lock-Free Concurrency Primitives (Header File)
+ * @Filename	:	concurrency.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	17/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+#ifndef SRC_UTILITIES_CONCURRENCY_H_
+#define SRC_UTILITIES_CONCURRENCY_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#ifdef HOST_BUILD
+
+/* Host build (e.g. one thread per ISR/core on a PC): standard types, a full
+ * compiler and CPU barrier for dmb(), and the compiler's atomics for the
+ * exclusive accesses */
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef XST_SUCCESS
+#define XST_SUCCESS					0L
+#define XST_FAILURE					1L
+#endif
+
+#define CONC_DMB()					__atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#else
+
+/* Xilinx files */
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+
+#define CONC_DMB()					dmb()
+
+#endif
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* -------- Atomic operations -------*/
+/*	atomicFetchAdd() and atomicCas() update a 32-bit word with the Cortex-A9
+*	exclusive accesses (LDREX/STREX), retried until the store succeeds. They
+*	work between ISRs and tasks on one core, and between the cores, without
+*	masking interrupts. Each is a full barrier (dmb before and after).
+*
+*	Every write to the word must use them: a plain store from the same core
+*	does not clear the exclusive monitor, so it can be lost. The word must be
+*	in Normal memory (DDR, OCM), not Device memory.
+*
+*	Used for the count of CPU0 ticks waiting on CPU1 (amp.c): the tick ISR
+*	adds to it, and the main loop takes one tick at a time with atomicCas().
+*	The host test is host_apps/host_tests/concurrency_test.c. */
+
+
+/* -------- Seqlock -------*/
+/*	A seqlock lets a reader take a consistent copy of multi-word data (e.g. a
+*	statistics block) written by an ISR, without masking interrupts, and
+*	without ever delaying the writer. The writer makes the sequence odd
+*	before it writes, and even again after:
+*	  writer:	seqlockWriteBegin(&lock); ...write...; seqlockWriteEnd(&lock);
+*	  reader:	do {
+*				    seq = seqlockReadBegin(&lock);
+*				    ...copy...
+*				} while (seqlockReadRetry(&lock, seq) != 0U);
+*	A copy that overlapped a write is taken again.
+*
+*	One writer at a time (writers of different priorities must exclude each
+*	other, e.g. with enterCritical()). On one core, the reader must not
+*	preempt the writer: it would wait for a write that cannot finish. Use it
+*	for data written at a higher priority than it is read (e.g. ISR to
+*	task or main loop), or by the other core. */
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+typedef struct {
+	volatile uint32_t seq;			// Odd while a write is in progress
+} seqlock_t;
+
+
+/*****************************************************************************/
+/************************ Macros (Inline Functions) **************************/
+/*****************************************************************************/
+
+/* -------- Atomic operations -------*/
+
+/* Adds value to *p_word; returns the old value */
+static inline uint32_t atomicFetchAdd(volatile uint32_t *p_word, uint32_t value)
+{
+#ifdef HOST_BUILD
+	return __atomic_fetch_add(p_word, value, __ATOMIC_SEQ_CST);
+#else
+	uint32_t old_value;
+	uint32_t new_value;
+	uint32_t failed;
+
+	CONC_DMB();
+	do
+	{
+		__asm__ __volatile__(
+			"ldrex	%0, [%3]\n\t"
+			"add	%1, %0, %4\n\t"
+			"strex	%2, %1, [%3]"
+			: "=&r" (old_value), "=&r" (new_value), "=&r" (failed)
+			: "r" (p_word), "r" (value)
+			: "memory");
+	} while (failed != 0U);
+	CONC_DMB();
+
+	return old_value;
+#endif
+}
+
+/* Writes desired to *p_word if it holds expected; returns the old value
+ * (the write was done if it equals expected) */
+static inline uint32_t atomicCas(volatile uint32_t *p_word, uint32_t expected, uint32_t desired)
+{
+#ifdef HOST_BUILD
+	uint32_t old_value = expected;
+	(void)__atomic_compare_exchange_n(p_word, &old_value, desired, 0,
+										__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return old_value;
+#else
+	uint32_t old_value;
+	uint32_t failed;
+
+	CONC_DMB();
+	do
+	{
+		__asm__ __volatile__(
+			"ldrex	%0, [%2]\n\t"
+			"mov	%1, #0\n\t"
+			"cmp	%0, %3\n\t"
+			"bne	1f\n\t"
+			"strex	%1, %4, [%2]\n"
+			"1:"
+			: "=&r" (old_value), "=&r" (failed)
+			: "r" (p_word), "r" (expected), "r" (desired)
+			: "cc", "memory");
+	} while (failed != 0U);
+	CONC_DMB();
+
+	return old_value;
+#endif
+}
+
+
+/* -------- Seqlock -------*/
+
+static inline void seqlockInit(seqlock_t *p_lock)
+{
+	p_lock->seq = 0U;
+	CONC_DMB();
+}
+
+static inline void seqlockWriteBegin(seqlock_t *p_lock)
+{
+	p_lock->seq = p_lock->seq + 1U;
+	CONC_DMB();						/* Odd before the data writes */
+}
+
+static inline void seqlockWriteEnd(seqlock_t *p_lock)
+{
+	CONC_DMB();						/* Data writes before even */
+	p_lock->seq = p_lock->seq + 1U;
+}
+
+/* Waits for no write in progress; returns the sequence to pass to
+ * seqlockReadRetry() */
+static inline uint32_t seqlockReadBegin(const seqlock_t *p_lock)
+{
+	uint32_t seq;
+
+	do
+	{
+		seq = p_lock->seq;
+	} while ((seq & 1U) != 0U);
+	CONC_DMB();						/* Sequence before the data reads */
+
+	return seq;
+}
+
+/* Returns 1 if the data read since seqlockReadBegin() may be torn */
+static inline uint32_t seqlockReadRetry(const seqlock_t *p_lock, uint32_t seq)
+{
+	CONC_DMB();						/* Data reads before the sequence */
+	return (p_lock->seq != seq) ? 1U : 0U;
+}
+
+
+#endif /* SRC_UTILITIES_CONCURRENCY_H_ */
@@ -0,0 +1,644 @@
+/******************************************************************************
+ * @Title		:	Frame Codec
+ * @Filename	:	frame_codec.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include <string.h>
+
+#include "frame_codec.h"
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* Receive buffer. Holds the frame being parsed, starting with its SOF
+ * (framed protocol) or its first command byte (unframed protocol). */
+static uint8_t			RxRaw[FRAME_MAX_NBYTES];
+static uint32_t			rx_count = 0U;			// Bytes held in RxRaw
+static uint32_t			rx_frame_nbytes = 0U;	// Size of the frame at RxRaw[0]
+
+/* Receive statistics */
+static frame_stats_t	FrameStats;
+static frame_stats_t	*p_FrameStats = &FrameStats;
+
+
+#if FRAME_PROTOCOL_FRAMED
+/* CRC-16/CCITT lookup table (poly 0x1021) */
+static const uint16_t	Crc16Table[256] = {
+	0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+	0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU,
+	0x1231U, 0x0210U, 0x3273U, 0x2252U, 0x52B5U, 0x4294U, 0x72F7U, 0x62D6U,
+	0x9339U, 0x8318U, 0xB37BU, 0xA35AU, 0xD3BDU, 0xC39CU, 0xF3FFU, 0xE3DEU,
+	0x2462U, 0x3443U, 0x0420U, 0x1401U, 0x64E6U, 0x74C7U, 0x44A4U, 0x5485U,
+	0xA56AU, 0xB54BU, 0x8528U, 0x9509U, 0xE5EEU, 0xF5CFU, 0xC5ACU, 0xD58DU,
+	0x3653U, 0x2672U, 0x1611U, 0x0630U, 0x76D7U, 0x66F6U, 0x5695U, 0x46B4U,
+	0xB75BU, 0xA77AU, 0x9719U, 0x8738U, 0xF7DFU, 0xE7FEU, 0xD79DU, 0xC7BCU,
+	0x48C4U, 0x58E5U, 0x6886U, 0x78A7U, 0x0840U, 0x1861U, 0x2802U, 0x3823U,
+	0xC9CCU, 0xD9EDU, 0xE98EU, 0xF9AFU, 0x8948U, 0x9969U, 0xA90AU, 0xB92BU,
+	0x5AF5U, 0x4AD4U, 0x7AB7U, 0x6A96U, 0x1A71U, 0x0A50U, 0x3A33U, 0x2A12U,
+	0xDBFDU, 0xCBDCU, 0xFBBFU, 0xEB9EU, 0x9B79U, 0x8B58U, 0xBB3BU, 0xAB1AU,
+	0x6CA6U, 0x7C87U, 0x4CE4U, 0x5CC5U, 0x2C22U, 0x3C03U, 0x0C60U, 0x1C41U,
+	0xEDAEU, 0xFD8FU, 0xCDECU, 0xDDCDU, 0xAD2AU, 0xBD0BU, 0x8D68U, 0x9D49U,
+	0x7E97U, 0x6EB6U, 0x5ED5U, 0x4EF4U, 0x3E13U, 0x2E32U, 0x1E51U, 0x0E70U,
+	0xFF9FU, 0xEFBEU, 0xDFDDU, 0xCFFCU, 0xBF1BU, 0xAF3AU, 0x9F59U, 0x8F78U,
+	0x9188U, 0x81A9U, 0xB1CAU, 0xA1EBU, 0xD10CU, 0xC12DU, 0xF14EU, 0xE16FU,
+	0x1080U, 0x00A1U, 0x30C2U, 0x20E3U, 0x5004U, 0x4025U, 0x7046U, 0x6067U,
+	0x83B9U, 0x9398U, 0xA3FBU, 0xB3DAU, 0xC33DU, 0xD31CU, 0xE37FU, 0xF35EU,
+	0x02B1U, 0x1290U, 0x22F3U, 0x32D2U, 0x4235U, 0x5214U, 0x6277U, 0x7256U,
+	0xB5EAU, 0xA5CBU, 0x95A8U, 0x8589U, 0xF56EU, 0xE54FU, 0xD52CU, 0xC50DU,
+	0x34E2U, 0x24C3U, 0x14A0U, 0x0481U, 0x7466U, 0x6447U, 0x5424U, 0x4405U,
+	0xA7DBU, 0xB7FAU, 0x8799U, 0x97B8U, 0xE75FU, 0xF77EU, 0xC71DU, 0xD73CU,
+	0x26D3U, 0x36F2U, 0x0691U, 0x16B0U, 0x6657U, 0x7676U, 0x4615U, 0x5634U,
+	0xD94CU, 0xC96DU, 0xF90EU, 0xE92FU, 0x99C8U, 0x89E9U, 0xB98AU, 0xA9ABU,
+	0x5844U, 0x4865U, 0x7806U, 0x6827U, 0x18C0U, 0x08E1U, 0x3882U, 0x28A3U,
+	0xCB7DU, 0xDB5CU, 0xEB3FU, 0xFB1EU, 0x8BF9U, 0x9BD8U, 0xABBBU, 0xBB9AU,
+	0x4A75U, 0x5A54U, 0x6A37U, 0x7A16U, 0x0AF1U, 0x1AD0U, 0x2AB3U, 0x3A92U,
+	0xFD2EU, 0xED0FU, 0xDD6CU, 0xCD4DU, 0xBDAAU, 0xAD8BU, 0x9DE8U, 0x8DC9U,
+	0x7C26U, 0x6C07U, 0x5C64U, 0x4C45U, 0x3CA2U, 0x2C83U, 0x1CE0U, 0x0CC1U,
+	0xEF1FU, 0xFF3EU, 0xCF5DU, 0xDF7CU, 0xAF9BU, 0xBFBAU, 0x8FD9U, 0x9FF8U,
+	0x6E17U, 0x7E36U, 0x4E55U, 0x5E74U, 0x2E93U, 0x3EB2U, 0x0ED1U, 0x1EF0U
+};
+#endif
+
+
+
+/****************************************************************************/
+/************************** Function Prototypes *****************************/
+/****************************************************************************/
+
+/* Functions internal to the frame codec */
+static uint32_t frameScan(void);
+#if FRAME_PROTOCOL_FRAMED
+static uint32_t frameValidAt(uint32_t idx);
+#endif
+static void frameDiscard(uint32_t start);
+static uint32_t frameStatsCmd(uint32_t field1, uint32_t field2);
+
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		frameParserReset()
+*
+* Description:	Empties the receive buffer. Any partly received frame is lost.
+*
+* Returns:		None.
+*
+* Notes:		Called when the comms block is initialised, and when the
+* 				baud rate is changed.
+*
+****************************************************************************/
+
+void frameParserReset(void)
+{
+	rx_count = 0U;
+	rx_frame_nbytes = 0U;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameRegisterCommands()
+*
+* Description:	Clears the receive statistics, and registers the frame codec
+* 				commands with the command handler.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if registration failed.
+*
+* Notes:		cmdHandlerInit() must be called first.
+*
+****************************************************************************/
+
+int frameRegisterCommands(void)
+{
+	p_FrameStats->n_frames = 0U;
+	p_FrameStats->crc_errors = 0U;
+	p_FrameStats->framing_errors = 0U;
+	p_FrameStats->dropped = 0U;
+
+	return registerCommand(GET_FRAME_STATS, frameStatsCmd);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameRxByte()
+*
+* Description:	Passes one received byte to the frame parser.
+*
+* 				Framed protocol: bytes outside a frame are discarded until a
+* 				SOF is seen. Once LEN has been received, the frame is complete
+* 				when LEN + 2 (CRC) further bytes are held.
+*
+* 				Unframed protocol: the frame is complete when the 10-byte
+* 				command frame, plus any payload indicated by the command, is
+* 				held (see getCommandPayloadSize()).
+*
+* param[in]		byte: The received byte.
+*
+* Returns:		1 if a complete, valid frame is available (see frameGetPayload()),
+* 				otherwise 0.
+*
+* Notes:		When 1 is returned, the frame must be handled and released with
+* 				frameConsume() before the next byte is passed in.
+*
+****************************************************************************/
+
+uint32_t frameRxByte(uint8_t byte)
+{
+
+#if FRAME_PROTOCOL_FRAMED
+	/* Outside a frame, discard everything up to the next SOF */
+	if ((rx_count == 0U) && (byte != FRAME_SOF))
+	{
+		return 0U;
+	}
+#endif
+
+	/* Buffer full without a complete frame: cannot happen with a valid
+	 * LEN, but protect the buffer anyway. */
+	if (rx_count >= FRAME_MAX_NBYTES)
+	{
+		p_FrameStats->framing_errors++;
+		frameDiscard(1U);
+	}
+
+	RxRaw[rx_count] = byte;
+	rx_count++;
+
+	return frameScan();
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameRxIdle()
+*
+* Description:	Called when the receive line has gone idle.
+*
+* 				A corrupted byte that looks like a SOF, followed by a plausible
+* 				LEN, makes the parser wait for bytes that will not come. If a
+* 				complete, valid frame follows it in the buffer, the bytes in
+* 				front of that frame are dropped and a framing error is counted.
+*
+* Returns:		1 if a complete, valid frame is now available, otherwise 0.
+*
+* Notes:		A genuine frame that is still being received is left alone,
+* 				so a host that pauses part-way through a frame is supported.
+*
+****************************************************************************/
+
+uint32_t frameRxIdle(void)
+{
+
+#if FRAME_PROTOCOL_FRAMED
+	uint32_t idx;
+
+	for (idx = 1U; idx < rx_count; idx++)
+	{
+		if ((RxRaw[idx] == FRAME_SOF) && (frameValidAt(idx) == 1U))
+		{
+			p_FrameStats->framing_errors++;
+			frameDiscard(idx);
+			return frameScan();
+		}
+	}
+#endif
+
+	return 0U;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameConsume()
+*
+* Description:	Releases the frame returned by frameRxByte(). Any bytes held
+* 				after the frame are kept and parsed.
+*
+* Returns:		1 if another complete frame is already available, otherwise 0.
+*
+* Notes:		None.
+*
+****************************************************************************/
+
+uint32_t frameConsume(void)
+{
+
+	rx_count -= rx_frame_nbytes;
+	memmove(RxRaw, &RxRaw[rx_frame_nbytes], rx_count);
+	rx_frame_nbytes = 0U;
+
+	frameDiscard(0U);
+
+	return frameScan();
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameGetPayload() / frameGetPayloadSize() / frameGetTag()
+*
+* Description:	Access to the frame returned by frameRxByte().
+*
+* Returns:		Pointer to the payload (the command frame) / its size in bytes /
+* 				the sequence tag (0 with the unframed protocol).
+*
+* Notes:		Only valid until frameConsume() is called.
+*
+****************************************************************************/
+
+uint8_t *frameGetPayload(void)
+{
+	return &RxRaw[FRAME_HEADER_NBYTES];
+}
+
+uint32_t frameGetPayloadSize(void)
+{
+	return (rx_frame_nbytes - FRAME_HEADER_NBYTES - FRAME_CRC_NBYTES);
+}
+
+uint8_t frameGetTag(void)
+{
+#if FRAME_PROTOCOL_FRAMED
+	return RxRaw[3];
+#else
+	return 0U;
+#endif
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameCountFramingError() / frameCountDropped()
+*
+* Description:	Count errors detected outside the parser:
+* 				- a valid frame whose LEN does not match the command it carries.
+* 				- received bytes that were lost because the receive ring was
+* 				full (too many requests in flight). Counted once per RX
+* 				interrupt in which bytes were lost.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void frameCountFramingError(void)
+{
+	p_FrameStats->framing_errors++;
+}
+
+void frameCountDropped(void)
+{
+	p_FrameStats->dropped++;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameEncode()
+*
+* Description:	Builds a frame around a payload that has already been written
+* 				to tx_buffer at offset FRAME_HEADER_NBYTES. The SOF, LEN and TAG
+* 				are written in front of the payload and the CRC after it.
+*
+* param[in]		*tx_buffer: Transmit buffer; must hold FRAME_MAX_NBYTES.
+* param[in]		n_bytes_payload: Size of the payload.
+* param[in]		tag: Sequence tag of the request being answered.
+*
+* Returns:		Number of bytes to transmit.
+*
+* Notes:		With the unframed protocol, the payload is sent as-is.
+*
+****************************************************************************/
+
+uint32_t frameEncode(uint8_t *tx_buffer, uint32_t n_bytes_payload, uint8_t tag)
+{
+
+#if FRAME_PROTOCOL_FRAMED
+	uint16_t crc;
+
+	tx_buffer[0] = FRAME_SOF;
+	tx_buffer[1] = (n_bytes_payload >> 8) & 0xFF;
+	tx_buffer[2] = n_bytes_payload & 0xFF;
+	tx_buffer[3] = tag;
+
+	crc = crc16Ccitt(0xFFFFU, &tx_buffer[1], n_bytes_payload + FRAME_HEADER_NBYTES - 1U);
+
+	tx_buffer[FRAME_HEADER_NBYTES + n_bytes_payload] = (crc >> 8) & 0xFF;
+	tx_buffer[FRAME_HEADER_NBYTES + n_bytes_payload + 1U] = crc & 0xFF;
+#endif
+
+	return (FRAME_HEADER_NBYTES + n_bytes_payload + FRAME_CRC_NBYTES);
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		crc16Ccitt()
+*
+* Description:	Table-driven CRC-16/CCITT (poly 0x1021, MSB first).
+*
+* param[in]		crc: Initial value (0xFFFF), or the result of a previous call.
+* param[in]		*data: Data to process.
+* param[in]		n_bytes: Number of bytes.
+*
+* Returns:		Updated CRC.
+*
+* Notes:		Not used with the unframed protocol.
+*
+****************************************************************************/
+
+uint16_t crc16Ccitt(uint16_t crc, const uint8_t *data, uint32_t n_bytes)
+{
+
+#if FRAME_PROTOCOL_FRAMED
+	uint32_t idx;
+
+	for (idx = 0; idx < n_bytes; idx++)
+	{
+		crc = (uint16_t)((crc << 8) ^ Crc16Table[((crc >> 8) ^ data[idx]) & 0xFF]);
+	}
+#endif
+
+	return crc;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameScan()
+*
+* Description:	Checks whether the bytes in RxRaw hold a complete, valid frame.
+*
+* 				Framed protocol: if LEN is out of range or the CRC is bad, the
+* 				error is counted and the frame's SOF is dropped. The remaining
+* 				bytes are searched for the next SOF and checked again, so a
+* 				valid frame that followed the bad one is not lost.
+*
+* Returns:		1 if a complete, valid frame starts at RxRaw[0], otherwise 0.
+*
+* Notes:		Sets rx_frame_nbytes to the size of the frame.
+*
+****************************************************************************/
+
+uint32_t frameScan(void)
+{
+
+#if FRAME_PROTOCOL_FRAMED
+
+	uint32_t len;
+	uint16_t crc;
+	uint16_t crc_rx;
+
+	for (;;)
+	{
+		/* Wait for SOF + LEN + TAG */
+		if (rx_count < FRAME_HEADER_NBYTES)
+		{
+			return 0U;
+		}
+
+		len = ((uint32_t)RxRaw[1] << 8) | RxRaw[2];
+		if ((len < CMD_FRAME_NBYTES) || (len > FRAME_MAX_PAYLOAD))
+		{
+			p_FrameStats->framing_errors++;
+			frameDiscard(1U);
+			continue;
+		}
+
+		/* Wait for the payload and CRC */
+		rx_frame_nbytes = FRAME_HEADER_NBYTES + len + FRAME_CRC_NBYTES;
+		if (rx_count < rx_frame_nbytes)
+		{
+			return 0U;
+		}
+
+		crc = crc16Ccitt(0xFFFFU, &RxRaw[1], len + FRAME_HEADER_NBYTES - 1U);
+		crc_rx = (uint16_t)(((uint32_t)RxRaw[FRAME_HEADER_NBYTES + len] << 8)
+						| RxRaw[FRAME_HEADER_NBYTES + len + 1U]);
+		if (crc != crc_rx)
+		{
+			p_FrameStats->crc_errors++;
+			frameDiscard(1U);
+			continue;
+		}
+
+		p_FrameStats->n_frames++;
+		return 1U;
+	}
+
+#else
+
+	/* Wait for the command frame, then for any payload */
+	if (rx_count < CMD_FRAME_NBYTES)
+	{
+		return 0U;
+	}
+
+	rx_frame_nbytes = CMD_FRAME_NBYTES + getCommandPayloadSize(RxRaw);
+	if (rx_count < rx_frame_nbytes)
+	{
+		return 0U;
+	}
+
+	p_FrameStats->n_frames++;
+	return 1U;
+
+#endif
+
+}
+
+
+
+#if FRAME_PROTOCOL_FRAMED
+/******************************************************************************
+*
+* Function:		frameValidAt()
+*
+* Description:	Checks for a complete frame with a valid LEN and CRC starting
+* 				at RxRaw[idx]. The frame statistics are not updated.
+*
+* param[in]		idx: Index of the SOF.
+*
+* Returns:		1 if a valid frame is held at idx, otherwise 0.
+*
+****************************************************************************/
+
+uint32_t frameValidAt(uint32_t idx)
+{
+
+	uint32_t len;
+	uint16_t crc_rx;
+
+	if ((rx_count - idx) < FRAME_HEADER_NBYTES)
+	{
+		return 0U;
+	}
+
+	len = ((uint32_t)RxRaw[idx + 1U] << 8) | RxRaw[idx + 2U];
+	if ((len < CMD_FRAME_NBYTES) || (len > FRAME_MAX_PAYLOAD)
+			|| ((rx_count - idx) < (FRAME_HEADER_NBYTES + len + FRAME_CRC_NBYTES)))
+	{
+		return 0U;
+	}
+
+	crc_rx = (uint16_t)(((uint32_t)RxRaw[idx + FRAME_HEADER_NBYTES + len] << 8)
+					| RxRaw[idx + FRAME_HEADER_NBYTES + len + 1U]);
+
+	return (crc16Ccitt(0xFFFFU, &RxRaw[idx + 1U], len + FRAME_HEADER_NBYTES - 1U) == crc_rx) ? 1U : 0U;
+
+}
+#endif
+
+
+
+/******************************************************************************
+*
+* Function:		frameDiscard()
+*
+* Description:	Framed protocol: drops the bytes in RxRaw before the first SOF
+* 				found at or after index 'start'. If there is no SOF, the buffer
+* 				is emptied. Unframed protocol: the buffer is emptied if 'start'
+* 				is non-zero.
+*
+* param[in]		start: Index at which to start searching for a SOF.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void frameDiscard(uint32_t start)
+{
+
+#if FRAME_PROTOCOL_FRAMED
+
+	uint32_t idx = start;
+
+	while ((idx < rx_count) && (RxRaw[idx] != FRAME_SOF))
+	{
+		idx++;
+	}
+
+	rx_count -= idx;
+	memmove(RxRaw, &RxRaw[idx], rx_count);
+
+#else
+
+	if (start != 0U)
+	{
+		rx_count = 0U;
+	}
+
+#endif
+
+	rx_frame_nbytes = 0U;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		frameStatsCmd()
+*
+* Description:	GET_FRAME_STATS command handler.
+* 				Field 1 = selector:
+* 				FRAME_STATS_FRAMES:			valid frames received.
+* 				FRAME_STATS_CRC_ERRORS:		frames discarded due to bad CRC.
+* 				FRAME_STATS_FRAMING_ERRORS:	framing errors.
+* 				FRAME_STATS_DROPPED:		receive ring overflows.
+* 				FRAME_STATS_CLEAR:			clears the statistics.
+*
+* Returns:		The statistic, WRITE_OKAY for FRAME_STATS_CLEAR, or CMD_ERROR
+* 				for an unknown selector.
+*
+****************************************************************************/
+
+uint32_t frameStatsCmd(uint32_t field1, uint32_t field2)
+{
+
+	switch (field1)
+	{
+	case FRAME_STATS_FRAMES:
+		return p_FrameStats->n_frames;
+
+	case FRAME_STATS_CRC_ERRORS:
+		return p_FrameStats->crc_errors;
+
+	case FRAME_STATS_FRAMING_ERRORS:
+		return p_FrameStats->framing_errors;
+
+	case FRAME_STATS_DROPPED:
+		return p_FrameStats->dropped;
+
+	case FRAME_STATS_CLEAR:
+		p_FrameStats->n_frames = 0U;
+		p_FrameStats->crc_errors = 0U;
+		p_FrameStats->framing_errors = 0U;
+		p_FrameStats->dropped = 0U;
+		return WRITE_OKAY;
+
+	default:
+		return CMD_ERROR;
+	}
+
+}
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
@@ -0,0 +1,152 @@
+/******************************************************************************
+ * @Title		:	Idle Mode (Header File)
+ * @Filename	:	idle.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+#ifndef SRC_UTILITIES_IDLE_H_
+#define SRC_UTILITIES_IDLE_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+/* Xilinx files */
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "xparameters.h"
+#include "xscugic.h"
+
+/* Command handler (command registration) */
+#include "cmd_handler.h"
+
+/* Seqlock (latency statistics, read without masking interrupts) */
+#include "concurrency.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* 1 = the main loop sleeps (WFI) when it has nothing to do;
+ * 0 = it polls (for comparison of the latency statistics) */
+#define IDLE_WFI					1
+
+/* Wake-up latency budget, in TTC0 counts (9ns): latencies above it are
+ * counted (IDLE_STATS_xxx_OVER). */
+#define IDLE_WAKE_BUDGET			111U	// 1us
+
+/* Tick interrupt (TTC0_INT_IRQ_ID, intr_sys.h): read in the GIC pending
+ * register to tell a wake-up by the tick from one by another interrupt */
+#define IDLE_TICK_INTR_ID			XPS_TTC0_0_INT_ID
+
+
+/* -------- Idle mode -------*/
+/*	When no tick is waiting to be dispatched and no command is waiting to
+*	be executed, the main loop calls idleWait(). With interrupts disabled,
+*	it checks again that there is no work (an interrupt may have arrived
+*	since the main loop looked), then executes WFI. The core stops until an
+*	interrupt is pending (TTC0 tick, UART1), even though it is masked;
+*	interrupts are then enabled, and the ISR runs before idleWait() returns.
+*	Checking with interrupts disabled means a wake-up cannot be missed.
+*
+*	The main loop no longer polls memory between ticks, which saves power
+*	and leaves the interconnect to the other bus masters. */
+
+
+/* -------- Wake-up latency -------*/
+/*	The TTC0 ISR reads the TTC0 counter on entry. The counter runs on past
+*	the tick, so the counts since the tick (see ttc0_if.h) are the time from
+*	the tick to the ISR, in TTC0 counts (9ns). It is recorded in one of two
+*	sets of statistics:
+*	  - WAKE: the tick arrived while the core was in idleWait(); this is
+*	    the wake-up latency (core restart, ISR entry). idleWait() checks
+*	    the tick's pending bit in the GIC before it enables interrupts: if
+*	    another interrupt (UART1, AMP doorbell) woke the core, a tick that
+*	    arrives during its ISR counts as BUSY;
+*	  - BUSY: the tick arrived while the core was running (interrupt
+*	    latency with the core awake, for comparison).
+*	The time spent asleep is measured with the Global Timer
+*	(COUNTS_PER_SECOND), with the time since the statistics were cleared,
+*	so that the fraction of time asleep can be worked out.
+*
+*	GET_IDLE_STATS: Field 1 = selector (IDLE_STATS_xxx). */
+
+#define IDLE_STATS_SLEEPS			0U
+#define IDLE_STATS_SLEEP_TIME_LO	1U
+#define IDLE_STATS_SLEEP_TIME_HI	2U
+#define IDLE_STATS_ELAPSED_LO		3U
+#define IDLE_STATS_ELAPSED_HI		4U
+#define IDLE_STATS_WAKE_N			5U
+#define IDLE_STATS_WAKE_MIN			6U
+#define IDLE_STATS_WAKE_MAX			7U
+#define IDLE_STATS_WAKE_MEAN		8U
+#define IDLE_STATS_WAKE_OVER		9U
+#define IDLE_STATS_BUSY_N			10U
+#define IDLE_STATS_BUSY_MIN			11U
+#define IDLE_STATS_BUSY_MAX			12U
+#define IDLE_STATS_BUSY_MEAN		13U
+#define IDLE_STATS_BUSY_OVER		14U
+#define IDLE_STATS_CLEAR			15U
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* Returns non-zero if the main loop has work waiting */
+typedef uint32_t (*idle_check_t)(void);
+
+/* Tick latency statistics (TTC0 counts) */
+typedef struct {
+	uint32_t n;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+	uint32_t over;				// Latencies above IDLE_WAKE_BUDGET
+} idle_latency_t;
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Initialisation */
+int idleRegisterCommands(void);
+
+/* Called from the main loop when there is nothing to do */
+uint32_t idleWait(idle_check_t work_pending);
+
+/* Called from the TTC0 ISR, on entry */
+void idleTickLatency(uint32_t latency);
+
+
+#endif /* SRC_UTILITIES_IDLE_H_ */
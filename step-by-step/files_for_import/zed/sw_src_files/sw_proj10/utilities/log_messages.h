@@ -0,0 +1,66 @@
+/******************************************************************************
+ * @Title		:	Deferred Logger Messages (Header File)
+ * @Filename	:	log_messages.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+#ifndef SRC_UTILITIES_LOG_MESSAGES_H_
+#define SRC_UTILITIES_LOG_MESSAGES_H_
+
+
+/* -------- Log message table -------*/
+/*	One entry per message: X(ID, "format").
+*
+*	The firmware only uses the ID (an enum, see logger.h); the format
+*	strings are not compiled into the target. The host decoder
+*	(host_apps/python/log_decoder.py) reads this file to build the same
+*	table, so IDs are numbered in the order below, starting from 0.
+*
+*	Arguments are raw 32-bit words (at most LOG_MAX_ARGS). Use %d/%i for
+*	signed values, and %u, %x, %X, %o or %c for unsigned ones. %s cannot be
+*	used: the host has no access to target memory.
+*
+*	Add new messages at the end, so that older captures still decode. */
+
+#define LOG_MESSAGES(X) \
+	X(LOG_REBOOT_STATUS,	"SLCR reboot status = 0x%08X (SWDT %u, AWDT0 %u, AWDT1 %u)") \
+	X(LOG_INIT_DRIVERS,		"Init: SCUGIC %d, SCUWDT %d, AXI GPIO %d, PS7 GPIO %d") \
+	X(LOG_INIT_COMMS,		"Init: TTC0 %d, UART1 %d, command handler %d") \
+	X(LOG_INIT_INTR,		"Interrupt system: TTC0 %d, UART1 %d, scheduler SGIs %d") \
+	X(LOG_ASSERT,			"Assertion in file (name at 0x%08X) on line %d") \
+	X(LOG_SEQ_STOPPED,		"Sequencer stopped at pc %u, error %u, %u results") \
+	X(LOG_UART_RX_ERROR,	"UART1 receive error: ISR = 0x%08X, %u bytes flushed") \
+	X(LOG_UART_BAUD,		"UART1 baud rate %u -> %u") \
+	X(LOG_INIT_SCHEDULER,	"Init: scheduler %d") \
+	X(LOG_SCHED_LATE,		"Task %u started late: %u ticks after its release") \
+	X(LOG_SCHED_OVERRUN,	"Task %u overran: returned %u ticks after its release") \
+	X(LOG_INIT_AMP,			"AMP: CPU%u init %d, doorbells %d") \
+	X(LOG_AMP_TIMEOUT,		"AMP: request %u (command 0x%04X) not answered by CPU0 in time") \
+	X(LOG_AMP_LATE,			"AMP: late response to request %u (tag %u, %u bytes)")
+
+
+#endif /* SRC_UTILITIES_LOG_MESSAGES_H_ */
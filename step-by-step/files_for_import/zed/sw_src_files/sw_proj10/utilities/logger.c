@@ -0,0 +1,262 @@
+/******************************************************************************
+ * @Title		:	Deferred Logger
+ * @Filename	:	logger.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include "logger.h"
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* Log ring (also readable with XSCT when no host is connected) */
+static uint32_t			LogBuffer[LOG_RING_WORDS];
+static log_ring_t		LogRing;
+static log_ring_t		*p_LogRing = &LogRing;
+
+/* Statistics */
+static log_stats_t		LogStats;
+static log_stats_t		*p_LogStats = &LogStats;
+
+
+
+/****************************************************************************/
+/************************** Function Prototypes *****************************/
+/****************************************************************************/
+
+/* Command handlers */
+static uint32_t logStatsCmd(uint32_t field1, uint32_t field2);
+
+/* Functions internal to this file */
+
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		logRegisterCommands()
+*
+* Description:	Registers GET_LOG_STATS with the command handler.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if registration failed.
+*
+* Notes:		cmdHandlerInit() must be called first. The ring itself needs no
+* 				initialisation, so records can be written before this call
+* 				(e.g. during sys_init()).
+*
+****************************************************************************/
+
+int logRegisterCommands(void)
+{
+	return registerCommand(GET_LOG_STATS, logStatsCmd);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		logWrite()
+*
+* Description:	Writes a record (header, timestamp and arguments) to the log
+* 				ring. If the ring is full, the record is dropped and counted.
+*
+* param[in]		id: Message ID (LOG_xxx, see log_messages.h).
+* param[in]		n_args: Number of arguments used (0 to LOG_MAX_ARGS).
+* param[in]		arg0..arg3: Arguments.
+*
+* Returns:		None.
+*
+* Notes:		Use the LOGx() macros rather than calling this directly. Safe
+* 				to call from the main loop and from interrupt handlers: the
+* 				record is written with interrupts disabled, so records from
+* 				different contexts are never interleaved.
+*
+****************************************************************************/
+
+void logWrite(uint32_t id, uint32_t n_args, uint32_t arg0, uint32_t arg1,
+				uint32_t arg2, uint32_t arg3)
+{
+
+	uint32_t irq_was_disabled = mfcpsr() & XIL_EXCEPTION_IRQ;
+	uint32_t args[LOG_MAX_ARGS] = { arg0, arg1, arg2, arg3 };
+	uint32_t n_words = LOG_HEADER_WORDS + n_args;
+	uint32_t wr;
+	uint32_t idx;
+	XTime timestamp;
+
+	Xil_ExceptionDisable();
+
+	XTime_GetTime(&timestamp);
+	wr = p_LogRing->wr;
+
+	if ( (LOG_RING_WORDS - (wr - p_LogRing->rd)) < n_words )
+	{
+		p_LogStats->n_dropped++;
+	}
+	else
+	{
+		LogBuffer[wr++ & (LOG_RING_WORDS - 1U)] = (id << 16) | (n_args << 8) | (p_LogRing->seq & 0xFFU);
+		LogBuffer[wr++ & (LOG_RING_WORDS - 1U)] = (uint32_t)(timestamp >> 32);
+		LogBuffer[wr++ & (LOG_RING_WORDS - 1U)] = (uint32_t)timestamp;
+
+		for (idx = 0; idx < n_args; idx++)
+		{
+			LogBuffer[wr++ & (LOG_RING_WORDS - 1U)] = args[idx];
+		}
+
+		p_LogRing->wr = wr;
+		p_LogStats->n_written++;
+	}
+	p_LogRing->seq++;
+
+	if (irq_was_disabled == 0U)
+	{
+		Xil_ExceptionEnable();
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		logDrain()
+*
+* Description:	Packs whole records, up to LOG_DRAIN_MAX_WORDS words, into one
+* 				unsolicited frame (TAG = FRAME_TAG_LOG) and queues it for the
+* 				host. The records are removed from the ring once the frame has
+* 				been queued; if the transmit queue is full they are kept and
+* 				sent on a later call.
+*
+* Returns:		None.
+*
+* Notes:		Called once per TTC0 cycle, from the main loop. Does nothing
+* 				with the unframed protocol.
+*
+****************************************************************************/
+
+void logDrain(void)
+{
+
+	uint8_t frame[LOG_DRAIN_MAX_WORDS * 4U];
+	uint32_t rd = p_LogRing->rd;
+	uint32_t wr = p_LogRing->wr;
+	uint32_t n_words = 0U;
+	uint32_t n_record;
+	uint32_t idx;
+
+	if (FRAME_PROTOCOL_FRAMED == 0)
+	{
+		return;
+	}
+
+	while ((rd + n_words) != wr)
+	{
+		n_record = LOG_HEADER_WORDS
+				+ ((LogBuffer[(rd + n_words) & (LOG_RING_WORDS - 1U)] >> 8) & 0xFFU);
+
+		if ((n_words + n_record) > LOG_DRAIN_MAX_WORDS)
+		{
+			break;
+		}
+
+		for (idx = 0; idx < n_record; idx++)
+		{
+			setResponseBytes(&frame[4U * n_words], LogBuffer[(rd + n_words) & (LOG_RING_WORDS - 1U)]);
+			n_words++;
+		}
+	}
+
+	if (n_words == 0U)
+	{
+		return;
+	}
+
+	if (sendDeferredResponse(FRAME_TAG_LOG, frame, 4U * n_words) == XST_SUCCESS)
+	{
+		p_LogRing->rd = rd + n_words;
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		logStatsCmd()
+*
+* Description:	GET_LOG_STATS: reads or clears the logger statistics.
+* 				Field 1 = selector (LOG_STATS_xxx).
+*
+* Returns:		The selected value (WRITE_OKAY for LOG_STATS_CLEAR), or
+* 				CMD_ERROR for an unknown selector.
+*
+****************************************************************************/
+
+uint32_t logStatsCmd(uint32_t field1, uint32_t field2)
+{
+
+	switch (field1)
+	{
+	case LOG_STATS_WRITTEN:
+		return p_LogStats->n_written;
+
+	case LOG_STATS_DROPPED:
+		return p_LogStats->n_dropped;
+
+	case LOG_STATS_PENDING:
+		return p_LogRing->wr - p_LogRing->rd;
+
+	case LOG_STATS_CLEAR:
+		p_LogStats->n_written = 0U;
+		p_LogStats->n_dropped = 0U;
+		return WRITE_OKAY;
+
+	default:
+		return CMD_ERROR;
+	}
+
+}
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
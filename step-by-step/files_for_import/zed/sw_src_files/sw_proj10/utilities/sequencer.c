@@ -0,0 +1,696 @@
+/******************************************************************************
+ * @Title		:	Register-Op Sequencer
+ * @Filename	:	sequencer.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include <string.h>
+
+#include "sequencer.h"
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* Program (bytecode) and results buffers */
+static uint8_t			SeqProgram[SEQ_PROGRAM_NBYTES];
+static uint32_t			SeqResults[SEQ_RESULTS_MAX_WORDS];
+
+/* Sequencer state */
+static seq_state_t		SeqState;
+static seq_state_t		*p_SeqState = &SeqState;
+
+
+
+/****************************************************************************/
+/************************** Function Prototypes *****************************/
+/****************************************************************************/
+
+/* Command handlers */
+static uint32_t seqRunCmd(uint32_t field1, uint32_t field2);
+static uint32_t seqStopCmd(uint32_t field1, uint32_t field2);
+static uint32_t seqStatusCmd(uint32_t field1, uint32_t field2);
+
+/* Interpreter */
+static uint32_t seqExecute(uint32_t budget_us);
+static uint32_t seqTaskBudgetUs(uint32_t period);
+static uint32_t seqFetch(uint32_t *p_pc, uint32_t n_words, uint32_t *operands);
+static uint32_t seqAddResult(uint32_t value);
+static void seqDelayUs(uint32_t us);
+
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		seqRegisterCommands()
+*
+* Description:	Registers SEQ_RUN, SEQ_STOP and SEQ_STATUS with the command
+* 				handler. (SEQ_LOAD and SEQ_READ_RESULTS carry a payload or a
+* 				variable-length response, and are dispatched by handleCommand().)
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if registration failed.
+*
+* Notes:		cmdHandlerInit() must be called first.
+*
+****************************************************************************/
+
+int seqRegisterCommands(void)
+{
+
+	int status = XST_SUCCESS;
+
+	p_SeqState->state = SEQ_STATE_IDLE;
+	p_SeqState->error = SEQ_ERR_NONE;
+	p_SeqState->pc = 0U;
+	p_SeqState->n_results = 0U;
+	p_SeqState->n_runs = 0U;
+
+	status |= registerCommand(SEQ_RUN, seqRunCmd);
+	status |= registerCommand(SEQ_STOP, seqStopCmd);
+	status |= registerCommand(SEQ_STATUS, seqStatusCmd);
+
+	return (status == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqLoadProgram()
+*
+* Description:	SEQ_LOAD: copies part of a program into the program buffer.
+* 				Loading at offset 0 starts a new program, so the rest of the
+* 				buffer is cleared (it reads as SEQ_OP_END).
+*
+* param[in]		offset: Byte offset in the program buffer.
+* param[in]		*data: Program bytes (checksum already verified).
+* param[in]		n_bytes: Number of bytes.
+*
+* Returns:		WRITE_OKAY, or CMD_ERROR if the program does not fit or the
+* 				sequencer is armed.
+*
+****************************************************************************/
+
+uint32_t seqLoadProgram(uint32_t offset, uint8_t *data, uint32_t n_bytes)
+{
+
+	if ( (p_SeqState->state == SEQ_STATE_ARMED)
+			|| (offset > SEQ_PROGRAM_NBYTES)
+			|| (n_bytes > (SEQ_PROGRAM_NBYTES - offset)) )
+	{
+		return CMD_ERROR;
+	}
+
+	if (offset == 0U)
+	{
+		memset(SeqProgram, 0, SEQ_PROGRAM_NBYTES);
+	}
+
+	memcpy(&SeqProgram[offset], data, n_bytes);
+
+	return WRITE_OKAY;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqReadResults()
+*
+* Description:	SEQ_READ_RESULTS: reads N words of the results buffer, starting
+* 				at word 'start'. The response is formatted as for READ_BLOCK:
+* 				N data words followed by a checksum word.
+*
+* param[in]		start: First result word.
+* param[in]		n_words: Number of words (1 to CMD_BLOCK_MAX_WORDS).
+* param[in]		*tx_buffer: Pointer to the transmit buffer in the comms block.
+*
+* Returns:		Number of response bytes. The response is CMD_ERROR (4 bytes)
+* 				if the range is beyond the results collected.
+*
+****************************************************************************/
+
+uint32_t seqReadResults(uint32_t start, uint32_t n_words, uint8_t *tx_buffer)
+{
+
+	uint32_t checksum = 0U;
+	uint32_t idx;
+
+	if ( (n_words == 0U) || (n_words > CMD_BLOCK_MAX_WORDS)
+			|| (start > p_SeqState->n_results)
+			|| (n_words > (p_SeqState->n_results - start)) )
+	{
+		setResponseBytes(tx_buffer, CMD_ERROR);
+		return RESPONSE_NBYTES;
+	}
+
+	for (idx = 0; idx < n_words; idx++)
+	{
+		checksum += SeqResults[start + idx];
+		setResponseBytes(tx_buffer + (idx * 4U), SeqResults[start + idx]);
+	}
+
+	setResponseBytes(tx_buffer + (n_words * 4U), checksum);
+
+	return ((n_words + 1U) * 4U);
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqTick()
+*
+* Description:	Runs an armed program (SEQ_RUN_TASK) from the TTC0 task slot.
+* 				With a period of 0 the program runs once; otherwise it runs
+* 				every 'period' TTC0 cycles until stopped or an error occurs.
+* 				Results accumulate across runs.
+*
+* Returns:		None.
+*
+* Notes:		Called once per TTC0 cycle, from the main loop. The program
+* 				runs to completion, so its DELAY/WAIT time is taken from the
+* 				task slot: a periodic run is limited to a share of its
+* 				period (see seqTaskBudgetUs()).
+*
+****************************************************************************/
+
+void seqTick(void)
+{
+
+	uint32_t error;
+
+	if (p_SeqState->state != SEQ_STATE_ARMED)
+	{
+		return;
+	}
+
+	if (p_SeqState->countdown != 0U)
+	{
+		p_SeqState->countdown--;
+		return;
+	}
+
+	error = seqExecute(seqTaskBudgetUs(p_SeqState->period));
+	p_SeqState->n_runs++;
+
+	if (error != SEQ_ERR_NONE)
+	{
+		p_SeqState->state = SEQ_STATE_ERROR;
+	}
+	else if (p_SeqState->period == 0U)
+	{
+		p_SeqState->state = SEQ_STATE_DONE;
+	}
+	else
+	{
+		p_SeqState->countdown = p_SeqState->period - 1U;
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqRunCmd()
+*
+* Description:	SEQ_RUN: clears the results and runs the program.
+* 				Field 1 = mode:
+* 				SEQ_RUN_NOW:	run to completion now; the response gives the
+* 								result.
+* 				SEQ_RUN_TASK:	arm the program to run from the TTC0 task slot;
+* 								Field 2 = period in TTC0 cycles (0 = once).
+*
+* Returns:		WRITE_OKAY, SEQ_RUN_ERROR | error code (SEQ_RUN_NOW), or
+* 				CMD_ERROR for an unknown mode.
+*
+****************************************************************************/
+
+uint32_t seqRunCmd(uint32_t field1, uint32_t field2)
+{
+
+	uint32_t error;
+
+	p_SeqState->n_results = 0U;
+	p_SeqState->n_runs = 0U;
+	p_SeqState->error = SEQ_ERR_NONE;
+	p_SeqState->pc = 0U;
+
+	switch (field1)
+	{
+	case SEQ_RUN_NOW:
+		error = seqExecute(SEQ_MAX_RUN_US);
+		p_SeqState->n_runs = 1U;
+		if (error != SEQ_ERR_NONE)
+		{
+			p_SeqState->state = SEQ_STATE_ERROR;
+			return (SEQ_RUN_ERROR | error);
+		}
+		p_SeqState->state = SEQ_STATE_DONE;
+		return WRITE_OKAY;
+
+	case SEQ_RUN_TASK:
+		p_SeqState->period = field2;
+		p_SeqState->countdown = 0U;
+		p_SeqState->state = SEQ_STATE_ARMED;
+		return WRITE_OKAY;
+
+	default:
+		return CMD_ERROR;
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqStopCmd()
+*
+* Description:	SEQ_STOP: disarms a program armed with SEQ_RUN_TASK. The
+* 				results are kept.
+*
+* Returns:		WRITE_OKAY.
+*
+****************************************************************************/
+
+uint32_t seqStopCmd(uint32_t field1, uint32_t field2)
+{
+
+	if (p_SeqState->state == SEQ_STATE_ARMED)
+	{
+		p_SeqState->state = SEQ_STATE_DONE;
+	}
+
+	return WRITE_OKAY;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqStatusCmd()
+*
+* Description:	SEQ_STATUS: reads the sequencer status.
+* 				Field 1 = selector (SEQ_STATUS_xxx).
+*
+* Returns:		The selected value, or CMD_ERROR for an unknown selector.
+*
+****************************************************************************/
+
+uint32_t seqStatusCmd(uint32_t field1, uint32_t field2)
+{
+
+	switch (field1)
+	{
+	case SEQ_STATUS_STATE:
+		return p_SeqState->state;
+
+	case SEQ_STATUS_ERROR:
+		return p_SeqState->error;
+
+	case SEQ_STATUS_PC:
+		return p_SeqState->pc;
+
+	case SEQ_STATUS_N_RESULTS:
+		return p_SeqState->n_results;
+
+	case SEQ_STATUS_N_RUNS:
+		return p_SeqState->n_runs;
+
+	default:
+		return CMD_ERROR;
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqExecute()
+*
+* Description:	Runs the program from the start until SEQ_OP_END or an error.
+* 				The bytecode is described in sequencer.h.
+*
+* param[in]		budget_us: Time budget of the run, in microseconds.
+*
+* Returns:		SEQ_ERR_NONE, or the error code. On an error, the program
+* 				counter of the failing instruction is kept in the state.
+*
+****************************************************************************/
+
+uint32_t seqExecute(uint32_t budget_us)
+{
+
+	uint32_t pc = 0U;
+	uint32_t op_pc;
+	uint32_t opcode;
+	uint32_t operands[4];
+	uint32_t error = SEQ_ERR_NONE;
+	uint32_t n_steps = 0U;
+	uint32_t reg_value;
+	XTime t_deadline;
+	XTime t_limit;
+	XTime t_now;
+
+	/* Loop stack: start of the loop body and runs remaining */
+	uint32_t loop_pc[SEQ_MAX_LOOP_DEPTH];
+	uint32_t loop_count[SEQ_MAX_LOOP_DEPTH];
+	uint32_t loop_depth = 0U;
+
+	XTime_GetTime(&t_now);
+	t_deadline = t_now + ((XTime)budget_us * SEQ_COUNTS_PER_US);
+
+	for (;;)
+	{
+		op_pc = pc;
+
+		if (pc >= SEQ_PROGRAM_NBYTES)
+		{
+			error = SEQ_ERR_BOUNDS;
+			break;
+		}
+
+		if (++n_steps > SEQ_MAX_STEPS)
+		{
+			error = SEQ_ERR_STEPS;
+			break;
+		}
+
+		XTime_GetTime(&t_now);
+		if (t_now >= t_deadline)
+		{
+			error = SEQ_ERR_TIME;
+			break;
+		}
+
+		opcode = SeqProgram[pc];
+		pc++;
+
+		switch (opcode)
+		{
+		case SEQ_OP_END:
+			break;
+
+		case SEQ_OP_WRITE:
+			error = seqFetch(&pc, 2U, operands);
+			if (error == SEQ_ERR_NONE)
+			{
+				Xil_Out32(operands[0], operands[1]);
+			}
+			break;
+
+		case SEQ_OP_READ:
+			error = seqFetch(&pc, 1U, operands);
+			if (error == SEQ_ERR_NONE)
+			{
+				error = seqAddResult(Xil_In32(operands[0]));
+			}
+			break;
+
+		case SEQ_OP_RMW:
+			error = seqFetch(&pc, 3U, operands);
+			if (error == SEQ_ERR_NONE)
+			{
+				modifyRegister(operands[0], operands[1], operands[2]);
+			}
+			break;
+
+		case SEQ_OP_WAIT:
+			error = seqFetch(&pc, 4U, operands);
+			if ((error == SEQ_ERR_NONE) && (operands[3] > SEQ_MAX_WAIT_US))
+			{
+				error = SEQ_ERR_WAIT_LIMIT;
+			}
+			if (error == SEQ_ERR_NONE)
+			{
+				/* Poll until the timeout, or the end of the budget */
+				XTime_GetTime(&t_now);
+				t_limit = t_now + ((XTime)operands[3] * SEQ_COUNTS_PER_US);
+				if (t_limit > t_deadline)
+				{
+					t_limit = t_deadline;
+				}
+				do {
+					reg_value = Xil_In32(operands[0]);
+					XTime_GetTime(&t_now);
+					if ((reg_value & operands[1]) == (operands[2] & operands[1]))
+					{
+						break;
+					}
+				} while (t_now < t_limit);
+
+				if ((reg_value & operands[1]) != (operands[2] & operands[1]))
+				{
+					error = (t_limit == t_deadline) ? SEQ_ERR_TIME : SEQ_ERR_WAIT_TIMEOUT;
+				}
+			}
+			break;
+
+		case SEQ_OP_DELAY:
+			error = seqFetch(&pc, 1U, operands);
+			if ((error == SEQ_ERR_NONE) && (operands[0] > SEQ_MAX_WAIT_US))
+			{
+				error = SEQ_ERR_WAIT_LIMIT;
+			}
+			if ( (error == SEQ_ERR_NONE)
+					&& ((t_now + ((XTime)operands[0] * SEQ_COUNTS_PER_US)) > t_deadline) )
+			{
+				error = SEQ_ERR_TIME;
+			}
+			if (error == SEQ_ERR_NONE)
+			{
+				seqDelayUs(operands[0]);
+			}
+			break;
+
+		case SEQ_OP_LOOP:
+			error = seqFetch(&pc, 1U, operands);
+			if ( (error == SEQ_ERR_NONE)
+					&& ((loop_depth == SEQ_MAX_LOOP_DEPTH) || (operands[0] == 0U)) )
+			{
+				error = SEQ_ERR_LOOP;
+			}
+			if (error == SEQ_ERR_NONE)
+			{
+				loop_pc[loop_depth] = pc;
+				loop_count[loop_depth] = operands[0];
+				loop_depth++;
+			}
+			break;
+
+		case SEQ_OP_ENDLOOP:
+			if (loop_depth == 0U)
+			{
+				error = SEQ_ERR_LOOP;
+			}
+			else if (--loop_count[loop_depth - 1U] != 0U)
+			{
+				pc = loop_pc[loop_depth - 1U];
+			}
+			else
+			{
+				loop_depth--;
+			}
+			break;
+
+		case SEQ_OP_TIMESTAMP:
+			XTime_GetTime(&t_now);
+			error = seqAddResult((uint32_t)t_now);
+			break;
+
+		default:
+			error = SEQ_ERR_OPCODE;
+			break;
+		}
+
+		if ((opcode == SEQ_OP_END) || (error != SEQ_ERR_NONE))
+		{
+			break;
+		}
+	}
+
+	p_SeqState->error = error;
+	p_SeqState->pc = op_pc;
+
+	if (error != SEQ_ERR_NONE)
+	{
+		LOG3(LOG_SEQ_STOPPED, op_pc, error, p_SeqState->n_results);
+	}
+
+	return error;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqTaskBudgetUs()
+*
+* Description:	Time budget of a SEQ_RUN_TASK run: SEQ_MAX_RUN_US for a single
+* 				run (period 0), otherwise 1/SEQ_TASK_BUDGET_DIV of the
+* 				period, at most SEQ_MAX_RUN_US.
+*
+* Returns:		The budget, in microseconds.
+*
+* Notes:		A periodic run must end within its period: taskServices()
+* 				catches up missed ticks, so a longer run would be re-run at
+* 				once, every time (see Time limits in sequencer.h).
+*
+****************************************************************************/
+
+uint32_t seqTaskBudgetUs(uint32_t period)
+{
+
+	if ( (period == 0U)
+			|| (period > ((SEQ_MAX_RUN_US / SEQ_TICK_US) * SEQ_TASK_BUDGET_DIV)) )
+	{
+		return SEQ_MAX_RUN_US;
+	}
+
+	return (period * SEQ_TICK_US) / SEQ_TASK_BUDGET_DIV;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqFetch()
+*
+* Description:	Reads n_words big-endian operand words at the program counter
+* 				and advances it.
+*
+* Returns:		SEQ_ERR_NONE, or SEQ_ERR_BOUNDS if the operands run past the
+* 				end of the program buffer.
+*
+****************************************************************************/
+
+uint32_t seqFetch(uint32_t *p_pc, uint32_t n_words, uint32_t *operands)
+{
+
+	uint32_t idx;
+	uint32_t pc = *p_pc;
+
+	if ((n_words * 4U) > (SEQ_PROGRAM_NBYTES - pc))
+	{
+		return SEQ_ERR_BOUNDS;
+	}
+
+	for (idx = 0; idx < n_words; idx++)
+	{
+		operands[idx] = ((uint32_t)SeqProgram[pc] << 24)
+						| ((uint32_t)SeqProgram[pc + 1U] << 16)
+						| ((uint32_t)SeqProgram[pc + 2U] << 8)
+						| (uint32_t)SeqProgram[pc + 3U];
+		pc += 4U;
+	}
+
+	*p_pc = pc;
+
+	return SEQ_ERR_NONE;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqAddResult()
+*
+* Description:	Appends a word to the results buffer.
+*
+* Returns:		SEQ_ERR_NONE, or SEQ_ERR_RESULTS_FULL.
+*
+****************************************************************************/
+
+uint32_t seqAddResult(uint32_t value)
+{
+
+	if (p_SeqState->n_results >= SEQ_RESULTS_MAX_WORDS)
+	{
+		return SEQ_ERR_RESULTS_FULL;
+	}
+
+	SeqResults[p_SeqState->n_results] = value;
+	p_SeqState->n_results++;
+
+	return SEQ_ERR_NONE;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		seqDelayUs()
+*
+* Description:	Busy-waits for the given number of microseconds, using the
+* 				Global Timer.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void seqDelayUs(uint32_t us)
+{
+
+	XTime t_start;
+	XTime t_now;
+
+	XTime_GetTime(&t_start);
+	do {
+		XTime_GetTime(&t_now);
+	} while ((t_now - t_start) < ((XTime)us * SEQ_COUNTS_PER_US));
+
+}
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
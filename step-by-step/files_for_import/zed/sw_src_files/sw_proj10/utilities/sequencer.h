@@ -0,0 +1,184 @@
+/******************************************************************************
+ * @Title		:	Register-Op Sequencer (Header File)
+ * @Filename	:	sequencer.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+#ifndef SRC_UTILITIES_SEQUENCER_H_
+#define SRC_UTILITIES_SEQUENCER_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+/* Xilinx files */
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+
+/* Command handler (command registration, modifyRegister()) */
+#include "cmd_handler.h"
+
+/* Deferred logger (errors) */
+#include "logger.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* Program and results buffer sizes */
+#define SEQ_PROGRAM_NBYTES			1024U
+#define SEQ_RESULTS_MAX_WORDS		CMD_BLOCK_MAX_WORDS		// One READ_BLOCK-sized fetch
+
+/* Limits */
+#define SEQ_MAX_LOOP_DEPTH			4U
+#define SEQ_MAX_STEPS				100000U		// Guard against runaway programs
+
+/* Time limits. A run blocks the main loop (SEQ_RUN_NOW) or the task slot
+ * (SEQ_RUN_TASK), and with it the watchdog service (SCUWDT timeout 6.44 s):
+ * each WAIT/DELAY is limited to SEQ_MAX_WAIT_US, and the run is stopped
+ * with SEQ_ERR_TIME once it has used its time budget. The budget is checked
+ * before each instruction, and a WAIT/DELAY that would outlast it stops the
+ * run instead, so a run ends within its budget (plus one register access).
+ *
+ * A single run (SEQ_RUN_NOW, or SEQ_RUN_TASK with a period of 0) has a
+ * budget of SEQ_MAX_RUN_US. A periodic run gets 1/SEQ_TASK_BUDGET_DIV of
+ * its period: taskServices() runs every scheduler tick (SEQ_TICK_US, see
+ * SCHED_TICK_RATE_HZ in ttc0_if.h) and catches up missed ticks, so a run
+ * longer than its period would be re-run at once by the catch-up, and the
+ * watchdog service would never run again. */
+#define SEQ_MAX_WAIT_US				100000U		// 100 ms per WAIT/DELAY
+#define SEQ_MAX_RUN_US				1000000U	// 1 s per single run
+#define SEQ_TICK_US					50U			// Scheduler tick
+#define SEQ_TASK_BUDGET_DIV			2U			// Periodic run: half its period
+
+/* Global Timer counts per microsecond (DELAY / WAIT) */
+#define SEQ_COUNTS_PER_US			(COUNTS_PER_SECOND / 1000000U)
+
+
+/* -------- Bytecode -------*/
+/*	Each instruction is a 1-byte opcode followed by its operands, each a
+*	big-endian 32-bit word:
+*
+*	OPCODE				OPERANDS					ACTION
+*	SEQ_OP_END			-							Stop (done).
+*	SEQ_OP_WRITE		ADDR VALUE					Xil_Out32(ADDR, VALUE)
+*	SEQ_OP_READ			ADDR						Append Xil_In32(ADDR) to results.
+*	SEQ_OP_RMW			ADDR AND_MASK XOR_MASK		reg = (reg & AND) ^ XOR, IRQs masked.
+*	SEQ_OP_WAIT			ADDR MASK VALUE TIMEOUT_US	Poll until (reg & MASK) == VALUE;
+*													error on timeout. TIMEOUT_US
+*													<= SEQ_MAX_WAIT_US.
+*	SEQ_OP_DELAY		US							Busy-wait US microseconds.
+*													US <= SEQ_MAX_WAIT_US.
+*	SEQ_OP_LOOP			COUNT						Run the instructions up to the
+*													matching SEQ_OP_ENDLOOP COUNT times.
+*	SEQ_OP_ENDLOOP		-							End of loop body.
+*	SEQ_OP_TIMESTAMP	-							Append Global Timer (low word) to
+*													results.
+*
+*	Loops can be nested up to SEQ_MAX_LOOP_DEPTH. A zeroed program buffer
+*	reads as SEQ_OP_END. A run is stopped with SEQ_ERR_STEPS after
+*	SEQ_MAX_STEPS instructions, and with SEQ_ERR_TIME at the end of its time
+*	budget (see Time limits, above). */
+
+#define SEQ_OP_END					0x00U
+#define SEQ_OP_WRITE				0x01U
+#define SEQ_OP_READ					0x02U
+#define SEQ_OP_RMW					0x03U
+#define SEQ_OP_WAIT					0x04U
+#define SEQ_OP_DELAY				0x05U
+#define SEQ_OP_LOOP					0x06U
+#define SEQ_OP_ENDLOOP				0x07U
+#define SEQ_OP_TIMESTAMP			0x08U
+
+
+/* SEQ_RUN modes (FIELD 1) */
+#define SEQ_RUN_NOW					0U		// Run to completion in the command
+#define SEQ_RUN_TASK				1U		// Run from the TTC0 task slot
+
+/* Sequencer states */
+#define SEQ_STATE_IDLE				0U
+#define SEQ_STATE_ARMED				1U		// Waiting for the task slot
+#define SEQ_STATE_DONE				2U
+#define SEQ_STATE_ERROR				3U
+
+/* Error codes */
+#define SEQ_ERR_NONE				0U
+#define SEQ_ERR_OPCODE				1U		// Unknown opcode
+#define SEQ_ERR_BOUNDS				2U		// Operand beyond end of program
+#define SEQ_ERR_RESULTS_FULL		3U
+#define SEQ_ERR_WAIT_TIMEOUT		4U
+#define SEQ_ERR_LOOP				5U		// Nesting too deep, or ENDLOOP without LOOP
+#define SEQ_ERR_STEPS				6U		// SEQ_MAX_STEPS exceeded
+#define SEQ_ERR_WAIT_LIMIT			7U		// WAIT/DELAY over SEQ_MAX_WAIT_US
+#define SEQ_ERR_TIME				8U		// Time budget used up
+
+/* SEQ_RUN response on error: SEQ_RUN_ERROR | error code */
+#define SEQ_RUN_ERROR				(0xEEAA5500U)
+
+/* SEQ_STATUS selectors (FIELD 1) */
+#define SEQ_STATUS_STATE			0U
+#define SEQ_STATUS_ERROR			1U
+#define SEQ_STATUS_PC				2U		// Program counter at the error
+#define SEQ_STATUS_N_RESULTS		3U
+#define SEQ_STATUS_N_RUNS			4U
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* Sequencer state */
+typedef struct {
+	uint32_t state;
+	uint32_t error;
+	uint32_t pc;				// Program counter (at the error, if any)
+	uint32_t n_results;
+	uint32_t n_runs;			// Completed runs
+	uint32_t period;			// SEQ_RUN_TASK: TTC0 cycles between runs (0 = once)
+	uint32_t countdown;			// SEQ_RUN_TASK: cycles to the next run
+} seq_state_t;
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Initialisation */
+int seqRegisterCommands(void);
+
+/* Called by the command handler for SEQ_LOAD / SEQ_READ_RESULTS */
+uint32_t seqLoadProgram(uint32_t offset, uint8_t *data, uint32_t n_bytes);
+uint32_t seqReadResults(uint32_t start, uint32_t n_words, uint8_t *tx_buffer);
+
+/* Called once per TTC0 cycle from the main loop */
+void seqTick(void);
+
+
+#endif /* SRC_UTILITIES_SEQUENCER_H_ */
@@ -0,0 +1,177 @@
+/******************************************************************************
+ * @Title		:	Single-Producer Single-Consumer Ring (Header File)
+ * @Filename	:	spsc_ring.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+#ifndef SRC_UTILITIES_SPSC_RING_H_
+#define SRC_UTILITIES_SPSC_RING_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+/* Barrier and types, for the target or a host build (HOST_BUILD) */
+#include "concurrency.h"
+
+#define SPSC_DMB()					CONC_DMB()
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* -------- SPSC ring -------*/
+/*	A fixed-capacity ring of items passed from one producer (e.g. an ISR)
+*	to one consumer (e.g. a task or the main loop), or from one core to the
+*	other, with no lock and no interrupt masking:
+*	  - head (items published) is written by the producer only, and tail
+*	    (items released) by the consumer only. Each is on its own cache
+*	    line, so the two sides do not share a line they both write;
+*	  - both run freely (modulo 2^32); the slot is index % capacity, so the
+*	    capacity must be a power of 2;
+*	  - the producer fills free slots in place, then publishes them: dmb,
+*	    then head += n. The consumer reads items in place, then releases
+*	    them: dmb, then tail += n. Free() and Count() read the other side's
+*	    index, then dmb. So the item contents are ordered against the index
+*	    that hands them over, on one core (ISR to task) and across the cores.
+*
+*	The ring is header-only: SPSC_RING_DEFINE(type, prefix, item, capacity)
+*	declares the ring type and its inline functions, e.g.
+*	  SPSC_RING_DEFINE(rx_ring_t, rxRing, uint8_t, 256U)
+*	gives rx_ring_t, and rxRingInit(), rxRingFree(), rxRingSlot(), ...
+*
+*	Producer:	prefixFree(r): number of free slots (n);
+*				prefixSlot(r, k): k-th free slot (k < n), to be filled;
+*				prefixPublish(r, k): hands over the first k slots filled.
+*	Consumer:	prefixCount(r): number of items (n);
+*				prefixItem(r, k): k-th oldest item (k < n), to be read;
+*				prefixRelease(r, k): gives the k oldest slots back.
+*	Copies:		prefixPush(r, &item), prefixPop(r, &item): one item, or
+*				XST_FAILURE if the ring is full / empty.
+*	Positions:	prefixHead(r), prefixTail(r): items published / released
+*				so far (e.g. to mark a position in a byte stream). */
+
+#define SPSC_CACHE_LINE				32U		// Cortex-A9 L1 line
+
+
+/*****************************************************************************/
+/************************ Macros (Inline Functions) **************************/
+/*****************************************************************************/
+
+#define SPSC_RING_DEFINE(type, prefix, item_t, capacity) \
+\
+typedef struct { \
+	volatile uint32_t head;					/* Published (producer) */ \
+	uint8_t pad_head[SPSC_CACHE_LINE - 4U]; \
+	volatile uint32_t tail;					/* Released (consumer) */ \
+	uint8_t pad_tail[SPSC_CACHE_LINE - 4U]; \
+	item_t slot[capacity]; \
+} __attribute__((aligned(SPSC_CACHE_LINE))) type; \
+\
+/* Capacity must be a power of 2 */ \
+typedef char prefix##CapacityCheck[(((capacity) & ((capacity) - 1U)) == 0U) ? 1 : -1]; \
+\
+static inline void prefix##Init(type *p_ring) \
+{ \
+	p_ring->head = 0U; \
+	p_ring->tail = 0U; \
+	SPSC_DMB(); \
+} \
+\
+static inline uint32_t prefix##Free(type *p_ring) \
+{ \
+	uint32_t n_free = (capacity) - (p_ring->head - p_ring->tail); \
+	SPSC_DMB();					/* Tail before the slot writes */ \
+	return n_free; \
+} \
+\
+static inline item_t *prefix##Slot(type *p_ring, uint32_t k) \
+{ \
+	return &p_ring->slot[(p_ring->head + k) & ((capacity) - 1U)]; \
+} \
+\
+static inline void prefix##Publish(type *p_ring, uint32_t k) \
+{ \
+	SPSC_DMB();					/* Slot writes before the head */ \
+	p_ring->head = p_ring->head + k; \
+} \
+\
+static inline uint32_t prefix##Count(type *p_ring) \
+{ \
+	uint32_t n_items = p_ring->head - p_ring->tail; \
+	SPSC_DMB();					/* Head before the item reads */ \
+	return n_items; \
+} \
+\
+static inline item_t *prefix##Item(type *p_ring, uint32_t k) \
+{ \
+	return &p_ring->slot[(p_ring->tail + k) & ((capacity) - 1U)]; \
+} \
+\
+static inline void prefix##Release(type *p_ring, uint32_t k) \
+{ \
+	SPSC_DMB();					/* Item reads before the tail */ \
+	p_ring->tail = p_ring->tail + k; \
+} \
+\
+static inline int prefix##Push(type *p_ring, const item_t *p_item) \
+{ \
+	if (prefix##Free(p_ring) == 0U) \
+	{ \
+		return XST_FAILURE; \
+	} \
+	*prefix##Slot(p_ring, 0U) = *p_item; \
+	prefix##Publish(p_ring, 1U); \
+	return XST_SUCCESS; \
+} \
+\
+static inline int prefix##Pop(type *p_ring, item_t *p_item) \
+{ \
+	if (prefix##Count(p_ring) == 0U) \
+	{ \
+		return XST_FAILURE; \
+	} \
+	*p_item = *prefix##Item(p_ring, 0U); \
+	prefix##Release(p_ring, 1U); \
+	return XST_SUCCESS; \
+} \
+\
+static inline uint32_t prefix##Head(const type *p_ring) \
+{ \
+	return p_ring->head; \
+} \
+\
+static inline uint32_t prefix##Tail(const type *p_ring) \
+{ \
+	return p_ring->tail; \
+}
+
+
+#endif /* SRC_UTILITIES_SPSC_RING_H_ */
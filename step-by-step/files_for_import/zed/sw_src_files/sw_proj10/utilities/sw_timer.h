@@ -0,0 +1,121 @@
+/******************************************************************************
+ * @Title		:	Software Timers (Header File)
+ * @Filename	:	sw_timer.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+#ifndef SRC_UTILITIES_SW_TIMER_H_
+#define SRC_UTILITIES_SW_TIMER_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#ifdef HOST_BUILD
+/* Host build (see concurrency.h): types and status codes only */
+#include "concurrency.h"
+#else
+/* Xilinx files */
+#include "xil_types.h"
+#include "xstatus.h"
+#endif
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* -------- Software timers -------*/
+/*	Any number of one-shot or periodic timers, driven by the scheduler tick.
+*	Each timer is a sw_timer_t owned by the module that uses it (no memory
+*	is allocated). When it expires, its callback is called from
+*	swTimerTick(), i.e. in task context (see taskTimers() in tasks.c), so
+*	callbacks may take time and may start or stop any timer, including
+*	their own.
+*
+*	The timers are kept in a hierarchical timer wheel: SW_TIMER_LEVELS
+*	levels of SW_TIMER_SLOTS slots. Level 0 holds the timers due in the next
+*	SW_TIMER_SLOTS ticks, one slot per tick. Each level above covers
+*	SW_TIMER_SLOTS times the range of the one below, one slot per range of
+*	the level below. When level 0 wraps, the timers of the next slot of
+*	level 1 are moved down (and so on up the levels), each to the slot of
+*	its expiry time. So:
+*	  - start and stop are O(1): a timer is linked into (or out of) the
+*	    list of one slot;
+*	  - each tick only runs the timers of one level 0 slot, all due. A
+*	    timer is moved down at most SW_TIMER_LEVELS - 1 times in its life.
+*	Timers that are not due cost nothing per tick, so the fast path does
+*	not grow with the number of timers.
+*
+*	The host test (host_apps/host_tests/sw_timer_test.c) checks the wheel
+*	against a reference model. */
+
+#define SW_TIMER_BITS				6U
+#define SW_TIMER_SLOTS				(1U << SW_TIMER_BITS)
+#define SW_TIMER_MASK				(SW_TIMER_SLOTS - 1U)
+#define SW_TIMER_LEVELS				5U
+
+/* Longest timeout, in ticks (2^30 - 1: about 14.9 hours at 50us) */
+#define SW_TIMER_MAX_TICKS			((1U << (SW_TIMER_BITS * SW_TIMER_LEVELS)) - 1U)
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* Expiry callback; p_arg is the argument given to swTimerInit() */
+typedef void (*sw_timer_func_t)(void *p_arg);
+
+/* A software timer. Set up with swTimerInit(); the fields are private. */
+typedef struct sw_timer {
+	struct sw_timer *next;			// Next timer in the slot
+	struct sw_timer **pprev;		// Link to this timer; NULL = not running
+	uint32_t expires;				// Tick of expiry
+	uint32_t period;				// Reload, in ticks; 0 = one-shot
+	sw_timer_func_t func;
+	void *p_arg;
+} sw_timer_t;
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Timer set-up and control (task context or main loop, not ISRs) */
+void swTimerInit(sw_timer_t *p_timer, sw_timer_func_t func, void *p_arg);
+int swTimerStart(sw_timer_t *p_timer, uint32_t ticks, uint32_t period);
+void swTimerStop(sw_timer_t *p_timer);
+uint32_t swTimerIsRunning(const sw_timer_t *p_timer);
+
+/* Called once per scheduler tick, from a task */
+void swTimerTick(void);
+uint32_t swTimerNow(void);
+
+
+#endif /* SRC_UTILITIES_SW_TIMER_H_ */
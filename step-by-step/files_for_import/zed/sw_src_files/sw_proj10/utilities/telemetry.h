@@ -0,0 +1,126 @@
+/******************************************************************************
+ * @Title		:	Telemetry Subscriptions (Header File)
+ * @Filename	:	telemetry.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+#ifndef SRC_UTILITIES_TELEMETRY_H_
+#define SRC_UTILITIES_TELEMETRY_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+/* Xilinx files */
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+
+/* Command handler (command registration, deferred responses) */
+#include "cmd_handler.h"
+
+/* Frame codec (FRAME_TAG_UNSOLICITED) */
+#include "frame_codec.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* Number of subscriptions that can be active at the same time */
+#define TELEM_MAX_SUBS				8U
+
+/* UNSUBSCRIBE: Field 1 value to cancel all subscriptions */
+#define TELEM_ALL					0xFFFFFFFFU
+
+/* Subscription modes */
+#define TELEM_MODE_PERIODIC			0U		// Push every sample
+#define TELEM_MODE_ON_CHANGE		1U		// Push only when the value changes
+
+
+/* -------- Telemetry frame -------*/
+/*	The target pushes each sample as an unsolicited frame, with
+*	TAG = FRAME_TAG_UNSOLICITED and a 16-byte payload:
+*	-----------------------------------------------
+*	| ID | SEQ (3) | TIME HI | TIME LO |   VALUE   |
+*	-----------------------------------------------
+*	ID = subscription ID (the SUBSCRIBE_xxx response).
+*	SEQ = per-subscription frame counter (24 bits); a gap means frames
+*	were dropped because the transmit queue was full.
+*	TIME = Global Timer count when the register was read (COUNTS_PER_SECOND).
+*	All words are big-endian.
+*
+*	Registers are sampled from the TTC0 task slot, so the sample period is
+*	an exact multiple of the TTC0 cycle. Telemetry needs the framed
+*	protocol (FRAME_PROTOCOL_FRAMED = 1). */
+
+#define TELEM_FRAME_NBYTES			16U
+
+
+/* GET_TELEM_STATS selectors (FIELD 1) */
+#define TELEM_STATS_SENT			0U
+#define TELEM_STATS_DROPPED			1U
+#define TELEM_STATS_ACTIVE			2U		// Number of active subscriptions
+#define TELEM_STATS_CLEAR			3U
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* A telemetry subscription */
+typedef struct {
+	uint32_t active;			// Entry in use
+	uint32_t mode;				// TELEM_MODE_xxx
+	uint32_t address;
+	uint32_t period;			// TTC0 cycles between samples (>= 1)
+	uint32_t countdown;			// TTC0 cycles to the next sample
+	uint32_t seq;				// Frames pushed (including dropped)
+	uint32_t last_value;		// ON_CHANGE: last value sent
+	uint32_t sent_once;			// ON_CHANGE: last_value is valid
+} telem_sub_t;
+
+/* Telemetry statistics */
+typedef struct {
+	volatile uint32_t n_sent;		// Telemetry frames queued for sending
+	volatile uint32_t n_dropped;	// Samples lost: transmit queue full
+} telem_stats_t;
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Initialisation */
+int telemRegisterCommands(void);
+
+/* Called once per TTC0 cycle from the main loop */
+void telemTick(void);
+
+
+#endif /* SRC_UTILITIES_TELEMETRY_H_ */
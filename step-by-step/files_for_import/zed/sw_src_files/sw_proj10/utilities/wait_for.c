@@ -0,0 +1,214 @@
+/******************************************************************************
+ * @Title		:	WAIT_FOR Condition Monitor
+ * @Filename	:	wait_for.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent/Avnet ZedBoard
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include "wait_for.h"
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* Pending WAIT_FOR requests */
+static wait_for_t		WaitTable[WAIT_FOR_MAX_PENDING];
+
+
+
+/****************************************************************************/
+/************************** Function Prototypes *****************************/
+/****************************************************************************/
+
+/* Functions internal to this file */
+static void setWaitResponse(uint8_t *tx_buffer, uint32_t status, uint32_t reg_value);
+
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		waitForStart()
+*
+* Description:	Starts a WAIT_FOR request. The condition is checked at once;
+* 				if it is already true (or the timeout is 0), the response is
+* 				written to tx_buffer. Otherwise the request is added to the
+* 				wait table and checked by waitForTick().
+*
+* param[in]		address, mask, value: Condition ((reg & mask) == (value & mask)).
+* param[in]		timeout: Timeout in TTC0 cycles.
+* param[in]		request_id: Passed to sendDeferredResponse() later.
+* param[in]		*tx_buffer: Transmit buffer for an immediate response.
+*
+* Returns:		Number of response bytes written: WAIT_FOR_RESP_NBYTES,
+* 				RESPONSE_NBYTES (CMD_ERROR: wait table full) or 0 (deferred).
+*
+* Notes:		Called from handleCommand().
+*
+****************************************************************************/
+
+uint32_t waitForStart(uint32_t address, uint32_t mask, uint32_t value,
+						uint32_t timeout, uint32_t request_id, uint8_t *tx_buffer)
+{
+
+	uint32_t reg_value = Xil_In32(address);
+	uint32_t idx;
+	wait_for_t *p_wait;
+
+	if ((reg_value & mask) == (value & mask))
+	{
+		setWaitResponse(tx_buffer, WRITE_OKAY, reg_value);
+		return WAIT_FOR_RESP_NBYTES;
+	}
+
+	if (timeout == 0U)
+	{
+		setWaitResponse(tx_buffer, WAIT_TIMEOUT, reg_value);
+		return WAIT_FOR_RESP_NBYTES;
+	}
+
+	/* Find a free entry */
+	for (idx = 0; idx < WAIT_FOR_MAX_PENDING; idx++)
+	{
+		p_wait = &WaitTable[idx];
+
+		if (p_wait->active == 0U)
+		{
+			p_wait->done = 0U;
+			p_wait->request_id = request_id;
+			p_wait->address = address;
+			p_wait->mask = mask;
+			p_wait->value = value & mask;
+			p_wait->ticks_left = timeout;
+			p_wait->reg_value = reg_value;
+			p_wait->active = 1U;
+			return 0U;
+		}
+	}
+
+	/* Table full */
+	setResponseBytes(tx_buffer, CMD_ERROR);
+	return RESPONSE_NBYTES;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		waitForTick()
+*
+* Description:	Checks the condition of each pending WAIT_FOR request, and
+* 				counts down its timeout. When the condition is true or the
+* 				timeout expires, the response is sent to the host.
+*
+* Returns:		None.
+*
+* Notes:		Called once per TTC0 cycle, from the main loop. If the
+* 				response cannot be queued, it is sent on a later cycle.
+*
+****************************************************************************/
+
+void waitForTick(void)
+{
+
+	uint32_t idx;
+	wait_for_t *p_wait;
+	uint8_t response[WAIT_FOR_RESP_NBYTES];
+
+	for (idx = 0; idx < WAIT_FOR_MAX_PENDING; idx++)
+	{
+		p_wait = &WaitTable[idx];
+
+		if (p_wait->active == 0U)
+		{
+			continue;
+		}
+
+		if (p_wait->done == 0U)
+		{
+			p_wait->reg_value = Xil_In32(p_wait->address);
+			p_wait->ticks_left--;
+
+			if ((p_wait->reg_value & p_wait->mask) == p_wait->value)
+			{
+				p_wait->status = WRITE_OKAY;
+				p_wait->done = 1U;
+			}
+			else if (p_wait->ticks_left == 0U)
+			{
+				p_wait->status = WAIT_TIMEOUT;
+				p_wait->done = 1U;
+			}
+		}
+
+		if (p_wait->done == 1U)
+		{
+			setWaitResponse(response, p_wait->status, p_wait->reg_value);
+			if (sendDeferredResponse(p_wait->request_id, response, WAIT_FOR_RESP_NBYTES) == XST_SUCCESS)
+			{
+				p_wait->active = 0U;
+			}
+		}
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		setWaitResponse()
+*
+* Description:	Writes the 8-byte WAIT_FOR response (STATUS, REG VALUE).
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void setWaitResponse(uint8_t *tx_buffer, uint32_t status, uint32_t reg_value)
+{
+	setResponseBytes(tx_buffer, status);
+	setResponseBytes(tx_buffer + 4U, reg_value);
+}
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
@@ -0,0 +1,622 @@
+/******************************************************************************
+ * @Title		:	Asymmetric Multiprocessing
+ * @Filename	:	amp.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include "amp.h"
+
+/* Command handler, comms block and logger (served across the cores) */
+#include "../utilities/cmd_handler.h"
+#include "../utilities/frame_codec.h"
+#include "../utilities/logger.h"
+#ifndef HOST_BUILD
+#include "../uart/ps7_uart1_if.h"
+#else
+/* Host build: the UART1 functions used here are provided by the test */
+uint32_t uart1WorkPending(void);
+int uart1QueueResponse(uint32_t request_id, uint8_t *response, uint32_t n_bytes);
+void uart1BaudTick(void);
+#endif
+
+
+/* Nothing in this file is built unless AMP_MODE = 1 */
+#if AMP_MODE
+
+#if (FRAME_MAX_PAYLOAD > IPC_MSG_MAX_NBYTES) || (CMD_MAX_RESPONSE_NBYTES > IPC_MSG_MAX_NBYTES)
+#error "IPC_MSG_MAX_NBYTES is too small for a command frame or a response"
+#endif
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* Shared block, in OCM (host build: a static block) */
+#ifndef HOST_BUILD
+static amp_shared_t * const p_shared = (amp_shared_t *)AMP_SHARED_BASE;
+#else
+static amp_shared_t AmpShared;
+static amp_shared_t * const p_shared = &AmpShared;
+#endif
+
+/* Doorbells received (both cores) */
+static volatile uint32_t amp_doorbells = 0U;
+
+/* CPU1: ticks received from CPU0 and not yet serviced. Added to by the tick
+ * ISR, taken from by the main loop: every write is atomic (concurrency.h). */
+static volatile uint32_t amp_ticks = 0U;
+
+/* CPU1: number of the last request sent */
+static uint32_t amp_seq = 0U;
+
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		ampInit()
+*
+* Description:	Maps the shared block. CPU0 then empties the queues and marks
+* 				the block as set up; CPU1 waits for that, and marks itself
+* 				as running.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE (CPU1: the shared block was not
+* 				set up by CPU0 within AMP_INIT_TIMEOUT_US).
+*
+* Notes:		CPU0 calls it before ampStartCpu1().
+*
+****************************************************************************/
+
+int ampInit(void)
+{
+
+#if AMP_CPU == 1
+	XTime t_start;
+	XTime t_now;
+#endif
+
+	/* Shareable, non-cacheable: each core sees the writes of the other */
+	Xil_SetTlbAttributes(AMP_SHARED_BASE, AMP_SHARED_TLB_ATTR);
+
+#if AMP_CPU == 0
+
+	p_shared->magic = 0U;
+	p_shared->cpu1_ready = 0U;
+	ipcQueueInit(&p_shared->request);
+	ipcQueueInit(&p_shared->response);
+	ipcQueueInit(&p_shared->frames);
+
+	/* Queues before the magic word */
+	CONC_DMB();
+	p_shared->magic = AMP_SHARED_MAGIC;
+
+#else
+
+	XTime_GetTime(&t_start);
+	while (p_shared->magic != AMP_SHARED_MAGIC)
+	{
+		XTime_GetTime(&t_now);
+		if ((t_now - t_start) > ((XTime)AMP_INIT_TIMEOUT_US * AMP_COUNTS_PER_US))
+		{
+			return XST_FAILURE;
+		}
+	}
+
+	CONC_DMB();
+	p_shared->cpu1_ready = 1U;
+
+#endif
+
+	return XST_SUCCESS;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampStartCpu1()
+*
+* Description:	Starts CPU1: writes its entry point to the address polled by
+* 				the boot ROM, and wakes it (SEV).
+*
+* Returns:		None.
+*
+* Notes:		CPU0, after ampInit(). Not needed (but harmless) when CPU1
+* 				has been started by the debugger.
+*
+****************************************************************************/
+
+void ampStartCpu1(void)
+{
+#ifndef HOST_BUILD
+	Xil_Out32(AMP_CPU1_START_ADDR, AMP_CPU1_ENTRY);
+	dsb();
+	sev();
+#endif
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampDoorbellHandler()
+*
+* Description:	Doorbell SGI: a message has been queued by the other core.
+*
+* param[in]		CallBackRef: Not used.
+*
+* Returns:		None.
+*
+* Notes:		The messages are handled by the main loop; the interrupt
+* 				only wakes it (see idleWait()).
+*
+****************************************************************************/
+
+void ampDoorbellHandler(void *CallBackRef)
+{
+	amp_doorbells++;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampTickHandler()
+*
+* Description:	Tick SGI (CPU1): CPU0 has had a TTC0 tick.
+*
+* param[in]		CallBackRef: Not used.
+*
+* Returns:		None.
+*
+* Notes:		The tick is serviced by ampServiceComms().
+*
+****************************************************************************/
+
+void ampTickHandler(void *CallBackRef)
+{
+	(void)atomicFetchAdd(&amp_ticks, 1U);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampRing()
+*
+* Description:	Raises an SGI on the other core.
+*
+* param[in]		cpu: Core to interrupt (0 or 1).
+* param[in]		sgi: AMP_SGI_DOORBELL or AMP_SGI_TICK.
+*
+* Returns:		None.
+*
+* Notes:		The DSB completes the writes to the shared block (e.g. a
+* 				queue push) before the interrupt can be taken. Does nothing
+* 				in the host build (the threads poll).
+*
+****************************************************************************/
+
+void ampRing(uint32_t cpu, uint32_t sgi)
+{
+#ifndef HOST_BUILD
+	dsb();
+	XScuGic_WriteReg(XPAR_PS7_SCUGIC_0_DIST_BASEADDR, XSCUGIC_SFI_TRIG_OFFSET,
+						AMP_SGI_TARGET(cpu) | sgi);
+#else
+	(void)cpu;
+	(void)sgi;
+#endif
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampServiceRequests()
+*
+* Description:	CPU0: executes the oldest command frame sent by CPU1, and
+* 				sends the response back.
+*
+* Returns:		1 if a frame was executed, 0 if there was nothing to do (or
+* 				the response queue is still full).
+*
+* Notes:		Called from the main loop, in place of uart1ServiceCommands().
+* 				The frame is executed in place, and the response is written
+* 				straight into the response queue. A deferred response
+* 				(0 bytes) is sent later through ampSendFrame().
+*
+****************************************************************************/
+
+uint32_t ampServiceRequests(void)
+{
+
+	ipc_msg_t *p_request;
+	ipc_msg_t *p_response;
+
+	if ((ipcQueueCount(&p_shared->request) == 0U)
+			|| (ipcQueueFree(&p_shared->response) == 0U))
+	{
+		return 0U;
+	}
+
+	p_request = ipcQueueItem(&p_shared->request, 0U);
+	p_response = ipcQueueSlot(&p_shared->response, 0U);
+
+	p_response->type = IPC_MSG_RESPONSE;
+	p_response->seq = p_request->seq;
+	p_response->request_id = p_request->request_id;
+	p_response->n_bytes = handleCommand(p_request->data, p_response->data,
+										p_request->request_id);
+
+	ipcQueueRelease(&p_shared->request, 1U);
+	ipcQueuePublish(&p_shared->response, 1U);
+	ampRing(1U, AMP_SGI_DOORBELL);
+
+	return 1U;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampRequestsPending()
+*
+* Description:	CPU0: checks for command frames from CPU1.
+*
+* Returns:		1 if a frame is waiting, 0 otherwise.
+*
+* Notes:		Part of the idle check of the main loop (see idleWait()).
+*
+****************************************************************************/
+
+uint32_t ampRequestsPending(void)
+{
+	return (ipcQueueCount(&p_shared->request) != 0U) ? 1U : 0U;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampSendFrame()
+*
+* Description:	CPU0: passes a deferred response, telemetry or log frame to
+* 				CPU1, which sends it to the host.
+*
+* param[in]		request_id: Frame tag (see sendDeferredResponse()).
+* param[in]		*response: Response bytes.
+* param[in]		n_bytes: Number of response bytes.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if the frame queue is full (try
+* 				again later) or the frame is too long.
+*
+* Notes:		The command responder of CPU0 (see setCommandResponder()).
+*
+****************************************************************************/
+
+int ampSendFrame(uint32_t request_id, uint8_t *response, uint32_t n_bytes)
+{
+
+	ipc_msg_t *p_msg;
+	uint32_t idx;
+
+	if ((ipcQueueFree(&p_shared->frames) == 0U) || (n_bytes > IPC_MSG_MAX_NBYTES))
+	{
+		return XST_FAILURE;
+	}
+
+	p_msg = ipcQueueSlot(&p_shared->frames, 0U);
+
+	p_msg->type = IPC_MSG_FRAME;
+	p_msg->seq = 0U;
+	p_msg->request_id = request_id;
+	p_msg->n_bytes = n_bytes;
+	for (idx = 0; idx < n_bytes; idx++)
+	{
+		p_msg->data[idx] = response[idx];
+	}
+
+	ipcQueuePublish(&p_shared->frames, 1U);
+	ampRing(1U, AMP_SGI_DOORBELL);
+
+	return XST_SUCCESS;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampSendLateResponse()
+*
+* Description:	CPU1: sends a response that came after ampCallCpu0() gave up
+* 				waiting for it, as the deferred response of its frame.
+*
+* param[in]		*p_msg: The response (from the response queue).
+*
+* Returns:		XST_SUCCESS if the response has been dealt with (release
+* 				it), XST_FAILURE if the UART cannot take it yet (try again).
+*
+* Notes:		ampCallCpu0() returned 0 (deferred) for the frame, so the
+* 				host is waiting for a response with its tag. A response of
+* 				0 bytes (deferred by CPU0 itself, sent later as a frame), or
+* 				to a BATCH record (CMD_REQUEST_ID_NONE, its BATCH response
+* 				has been sent with CMD_PENDING), is not sent.
+*
+****************************************************************************/
+
+static int ampSendLateResponse(ipc_msg_t *p_msg)
+{
+
+	if ((p_msg->n_bytes == 0U) || (p_msg->request_id == CMD_REQUEST_ID_NONE))
+	{
+		return XST_SUCCESS;
+	}
+
+	if (uart1QueueResponse(p_msg->request_id, p_msg->data, p_msg->n_bytes) != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	LOG3(LOG_AMP_LATE, p_msg->seq, p_msg->request_id, p_msg->n_bytes);
+
+	return XST_SUCCESS;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampServiceComms()
+*
+* Description:	CPU1: sends the oldest frame queued by CPU0 to the host, and
+* 				any late response (see ampCallCpu0()), and runs the per-tick
+* 				comms services for a tick of CPU0.
+*
+* Returns:		1 if there was something to do, 0 otherwise.
+*
+* Notes:		Called from the main loop. A frame that the UART cannot take
+* 				yet is left in the queue, and tried again on the next call.
+*
+****************************************************************************/
+
+uint32_t ampServiceComms(void)
+{
+
+	ipc_msg_t *p_msg;
+	uint32_t n_ticks;
+	uint32_t work = 0U;
+
+	/* Responses: outside ampCallCpu0(), every response is a late one */
+	if (ipcQueueCount(&p_shared->response) != 0U)
+	{
+		p_msg = ipcQueueItem(&p_shared->response, 0U);
+		if (ampSendLateResponse(p_msg) == XST_SUCCESS)
+		{
+			ipcQueueRelease(&p_shared->response, 1U);
+		}
+		work = 1U;
+	}
+
+	/* Frames from CPU0 (deferred responses, telemetry, log) */
+	if (ipcQueueCount(&p_shared->frames) != 0U)
+	{
+		p_msg = ipcQueueItem(&p_shared->frames, 0U);
+		if (uart1QueueResponse(p_msg->request_id, p_msg->data, p_msg->n_bytes) == XST_SUCCESS)
+		{
+			ipcQueueRelease(&p_shared->frames, 1U);
+		}
+		work = 1U;
+	}
+
+	/* Ticks of CPU0: the services that run once per TTC0 cycle on CPU0 in
+	 * the single-core build (see taskServices()). One tick is taken at a
+	 * time; the ISR may add more meanwhile. */
+	do
+	{
+		n_ticks = amp_ticks;
+	} while ((n_ticks != 0U) && (atomicCas(&amp_ticks, n_ticks, n_ticks - 1U) != n_ticks));
+
+	if (n_ticks != 0U)
+	{
+		uart1BaudTick();
+		logDrain();
+		work = 1U;
+	}
+
+	return work;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampCommsWorkPending()
+*
+* Description:	CPU1: checks for work for the main loop.
+*
+* Returns:		1 if UART1, a frame or late response from CPU0 or a tick is
+* 				waiting, 0 otherwise.
+*
+* Notes:		Idle check of the CPU1 main loop (see idleWait()).
+*
+****************************************************************************/
+
+uint32_t ampCommsWorkPending(void)
+{
+	return (uart1WorkPending()
+			| ((ipcQueueCount(&p_shared->frames) != 0U) ? 1U : 0U)
+			| ((ipcQueueCount(&p_shared->response) != 0U) ? 1U : 0U)
+			| ((amp_ticks != 0U) ? 1U : 0U));
+}
+
+
+
+/******************************************************************************
+*
+* Function:		ampCallCpu0()
+*
+* Description:	CPU1: sends a command frame to CPU0, and waits for the
+* 				response.
+*
+* param[in]		*rx_buffer: Frame and payload.
+* param[in]		n_bytes: Number of frame and payload bytes.
+* param[in]		*tx_buffer: Transmit buffer.
+* param[in]		tx_nbytes: Space in the transmit buffer (at least
+* 				RESPONSE_NBYTES; CMD_MAX_RESPONSE_NBYTES for a whole frame).
+* param[in]		request_id: Frame tag, for a deferred response
+* 				(CMD_REQUEST_ID_NONE: the response cannot be deferred).
+*
+* Returns:		Number of response bytes written to the transmit buffer
+* 				(0 = deferred, as handleCommand()).
+*
+* Notes:		The command remote of CPU1 (see setCommandRemote()).
+* 				If CPU0 does not respond within AMP_CALL_TIMEOUT_US, the
+* 				frame stays queued, and CPU0 runs it later: the response is
+* 				deferred (0), and the late response is sent with the frame
+* 				tag when it comes (ampSendLateResponse()). Without a tag,
+* 				the response is CMD_PENDING (the command may still run), and
+* 				the late response is not sent.
+* 				CMD_ERROR: the frame could not be sent (request queue full,
+* 				or too long), or its response does not fit in tx_nbytes.
+*
+****************************************************************************/
+
+uint32_t ampCallCpu0(uint8_t *rx_buffer, uint32_t n_bytes, uint8_t *tx_buffer,
+						uint32_t tx_nbytes, uint32_t request_id)
+{
+
+	ipc_msg_t *p_msg;
+	uint32_t idx;
+	uint32_t n_tx;
+	uint32_t timed_out = 1U;
+	XTime t_start;
+	XTime t_now;
+
+	/* ----- Send the frame ----- */
+	if ((ipcQueueFree(&p_shared->request) != 0U) && (n_bytes <= IPC_MSG_MAX_NBYTES))
+	{
+		p_msg = ipcQueueSlot(&p_shared->request, 0U);
+		amp_seq++;
+		p_msg->type = IPC_MSG_REQUEST;
+		p_msg->seq = amp_seq;
+		p_msg->request_id = request_id;
+		p_msg->n_bytes = n_bytes;
+		for (idx = 0; idx < n_bytes; idx++)
+		{
+			p_msg->data[idx] = rx_buffer[idx];
+		}
+
+		ipcQueuePublish(&p_shared->request, 1U);
+		ampRing(0U, AMP_SGI_DOORBELL);
+
+
+		/* ----- Wait for its response ----- */
+		XTime_GetTime(&t_start);
+		do
+		{
+			if (ipcQueueCount(&p_shared->response) != 0U)
+			{
+				p_msg = ipcQueueItem(&p_shared->response, 0U);
+				if (p_msg->seq == amp_seq)
+				{
+					n_tx = p_msg->n_bytes;
+					if (n_tx <= tx_nbytes)
+					{
+						for (idx = 0; idx < n_tx; idx++)
+						{
+							tx_buffer[idx] = p_msg->data[idx];
+						}
+					}
+					ipcQueueRelease(&p_shared->response, 1U);
+
+					if (n_tx <= tx_nbytes)
+					{
+						return n_tx;
+					}
+					timed_out = 0U;
+					break;	// Too long for the caller: CMD_ERROR
+				}
+
+				/* Late response to an earlier request: send it first (the
+				 * queue is in order). Until the UART can take it, wait. */
+				if (ampSendLateResponse(p_msg) == XST_SUCCESS)
+				{
+					ipcQueueRelease(&p_shared->response, 1U);
+				}
+			}
+
+			XTime_GetTime(&t_now);
+		} while ((t_now - t_start) < ((XTime)AMP_CALL_TIMEOUT_US * AMP_COUNTS_PER_US));
+
+		if (timed_out != 0U)
+		{
+			LOG2(LOG_AMP_TIMEOUT, amp_seq, ((uint32_t)rx_buffer[0] << 8) | rx_buffer[1]);
+
+			/* ----- No response yet: deferred (or CMD_PENDING) ----- */
+			if (request_id != CMD_REQUEST_ID_NONE)
+			{
+				return 0U;
+			}
+			setResponseBytes(tx_buffer, CMD_PENDING);
+			return RESPONSE_NBYTES;
+		}
+	}
+
+
+	/* ----- Not sent (or too long): CMD_ERROR ----- */
+	setResponseBytes(tx_buffer, CMD_ERROR);
+
+	return RESPONSE_NBYTES;
+
+}
+
+#endif /* AMP_MODE */
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
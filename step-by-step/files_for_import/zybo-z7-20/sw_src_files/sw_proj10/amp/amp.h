@@ -0,0 +1,194 @@
+/******************************************************************************
+ * @Title		:	Asymmetric Multiprocessing (Header File)
+ * @Filename	:	amp.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+#ifndef SRC_AMP_AMP_H_
+#define SRC_AMP_AMP_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#ifndef HOST_BUILD
+/* Xilinx files */
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xscugic.h"
+#include "xil_io.h"
+#include "xil_mmu.h"
+#include "xtime_l.h"
+#include "xpseudo_asm.h"
+#endif
+
+/* Inter-core message queues */
+#include "ipc_queue.h"
+
+/* Atomic counters (ticks of CPU0, see amp.c) */
+#include "../utilities/concurrency.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* -------- AMP build -------*/
+/*	With AMP_MODE = 1, the sources are built twice, one application per
+*	Cortex-A9 core (the core is XPAR_CPU_ID, from the BSP of each
+*	application):
+*	  - CPU0 (real time): TTC0, the scheduler and its tasks, GPIO, the WDT,
+*	    and the execution of every command;
+*	  - CPU1 (comms): UART1, the frame layer and the command parser. The
+*	    commands registered on CPU1 (UART and frame commands) run there;
+*	    every other command frame is passed to CPU0 (setCommandRemote()),
+*	    and the response passed back.
+*	UART1 interrupts go to CPU1 only, so they never delay the TTC0 tasks.
+*
+*	The cores share a block of OCM (AMP_SHARED_BASE) with three message
+*	queues (see ipc_queue.h):
+*	  request:  CPU1 -> CPU0, command frames (one at a time: CPU1 waits
+*	            for the response, at most AMP_CALL_TIMEOUT_US);
+*	  response: CPU0 -> CPU1, responses (0 bytes = deferred, e.g. WAIT_FOR;
+*	            one that comes after the wait is sent as a deferred
+*	            response, see ampCallCpu0());
+*	  frames:   CPU0 -> CPU1, deferred responses, telemetry and log frames
+*	            (the command responder of CPU0, see ampSendFrame()).
+*	After pushing a message, the producer rings the doorbell of the other
+*	core (SGI AMP_SGI_DOORBELL), which wakes it from WFI (see idle.h). The
+*	TTC0 ISR also rings the tick SGI of CPU1 (AMP_SGI_TICK), which runs the
+*	per-tick comms services (baud rate negotiation, log drain).
+*
+*	Set-up of the two applications (Vitis):
+*	  - AMP_MODE = 1 in both (the same source files are imported into each);
+*	  - CPU1 BSP: compiler flag -DUSE_AMP=1 (CPU1 does not initialise the
+*	    GIC distributor or the L2 cache), stdout = UART1; CPU0 BSP: stdout
+*	    = none (UART1 belongs to CPU1);
+*	  - CPU1 linker script: DDR from AMP_CPU1_ENTRY; CPU0 linker script:
+*	    DDR below it. Neither may use OCM from AMP_SHARED_BASE.
+*	CPU0 initialises the shared block, then starts CPU1 (ampStartCpu1()).
+*	When debugging with JTAG, start CPU0 first.
+*
+*	With AMP_MODE = 0, CPU0 runs everything (CPU1 is not used). */
+
+#ifndef HOST_BUILD
+
+#define AMP_MODE					0
+
+#define AMP_CPU						XPAR_CPU_ID
+
+#else
+
+/* Host build (host_apps/host_tests/amp_test.c): both sides of the AMP link
+ * in one program, one thread per core. The shared block is a static block,
+ * the doorbells do nothing (the threads poll), and the Global Timer is
+ * XTime_GetTime() of the test. */
+#define AMP_MODE					1
+
+#define AMP_CPU						0
+
+typedef uint64_t XTime;
+#define COUNTS_PER_SECOND			1000000000U		// ns
+void XTime_GetTime(XTime *Xtime_Global);
+
+#define Xil_SetTlbAttributes(addr, attrib)	((void)(addr), (void)(attrib))
+
+#endif
+
+/* 1 in the CPU1 (comms) application of the AMP build */
+#define AMP_COMMS_IMAGE				((AMP_MODE == 1) && (AMP_CPU == 1))
+
+
+/* Shared block: high OCM (0xFFFF0000, 64KB), below the CPU1 start address
+ * word (0xFFFFFFF0). Mapped as shareable, non-cacheable normal memory by
+ * both cores (S = 1, TEX = 4, C = B = 0; the 1MB section containing it). */
+#define AMP_SHARED_BASE				0xFFFF0000U
+#define AMP_SHARED_TLB_ATTR			0x14de2U
+#define AMP_SHARED_MAGIC			0x414D5030U		// "AMP0"
+
+/* Start of CPU1: address read by the CPU1 boot ROM loop, and the entry
+ * point of the CPU1 application (start of its DDR, see its lscript.ld) */
+#define AMP_CPU1_START_ADDR			0xFFFFFFF0U
+#define AMP_CPU1_ENTRY				0x02000000U
+
+/* Software generated interrupts (SGIs 0 - 5 are the scheduler levels) */
+#define AMP_SGI_DOORBELL			14U		// Both cores: messages queued
+#define AMP_SGI_TICK				15U		// CPU1: TTC0 tick of CPU0
+#define AMP_SGI_TARGET(cpu)			(0x00010000U << (cpu))	// CPU target list
+
+/* Longest wait of CPU1 for a response from CPU0, and for CPU0 at start-up */
+#define AMP_CALL_TIMEOUT_US			10000U
+#define AMP_INIT_TIMEOUT_US			1000000U
+#define AMP_COUNTS_PER_US			(COUNTS_PER_SECOND / 1000000U)
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* Shared block */
+typedef struct {
+	volatile uint32_t magic;		// AMP_SHARED_MAGIC: set up by CPU0
+	volatile uint32_t cpu1_ready;	// CPU1 is running
+	uint8_t pad[SPSC_CACHE_LINE - 8U];
+	ipc_queue_t request;			// CPU1 -> CPU0
+	ipc_queue_t response;			// CPU0 -> CPU1
+	ipc_queue_t frames;				// CPU0 -> CPU1
+} amp_shared_t;
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Initialisation (both cores), and start of CPU1 (CPU0) */
+int ampInit(void);
+void ampStartCpu1(void);
+
+/* Interrupt handlers (see addAmpToInterruptSystem()) */
+void ampDoorbellHandler(void *CallBackRef);
+void ampTickHandler(void *CallBackRef);
+
+/* Doorbells */
+void ampRing(uint32_t cpu, uint32_t sgi);
+
+/* CPU0: main loop, command responder */
+uint32_t ampServiceRequests(void);
+uint32_t ampRequestsPending(void);
+int ampSendFrame(uint32_t request_id, uint8_t *response, uint32_t n_bytes);
+
+/* CPU1: main loop, command remote */
+uint32_t ampServiceComms(void);
+uint32_t ampCommsWorkPending(void);
+uint32_t ampCallCpu0(uint8_t *rx_buffer, uint32_t n_bytes, uint8_t *tx_buffer,
+						uint32_t tx_nbytes, uint32_t request_id);
+
+
+#endif /* SRC_AMP_AMP_H_ */
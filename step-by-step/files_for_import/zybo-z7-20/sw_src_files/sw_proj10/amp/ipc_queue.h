@@ -0,0 +1,93 @@
+/******************************************************************************
+ * @Title		:	Inter-Core Message Queues (Header File)
+ * @Filename	:	ipc_queue.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+#ifndef SRC_AMP_IPC_QUEUE_H_
+#define SRC_AMP_IPC_QUEUE_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+/* Lock-free ring (header-only; HOST_BUILD for a host build) */
+#include "../utilities/spsc_ring.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* -------- Message queues -------*/
+/*	A queue carries messages from one core (the producer) to the other (the
+*	consumer), in shared memory, without locks. Each queue is an SPSC ring
+*	of messages (see spsc_ring.h), which are built and read in place:
+*	  producer: ipcQueueFree(), then fill *ipcQueueSlot(q, 0), then
+*	            ipcQueuePublish(q, 1);
+*	  consumer: ipcQueueCount(), then read *ipcQueueItem(q, 0), then
+*	            ipcQueueRelease(q, 1).
+*	The barriers of the ring order the message contents against the index
+*	that hands them over, so neither core sees a half-written message.
+*
+*	Exactly one producer and one consumer per queue (e.g. the main loop of
+*	each core). With HOST_BUILD defined, the queues have no Xilinx
+*	dependency, so they can be run on a host with one thread per core. */
+
+#define IPC_QUEUE_SLOTS				4U		// Power of 2
+
+/* Largest message: a command frame and its payload (FRAME_MAX_PAYLOAD,
+ * 1038 bytes), or a response (CMD_MAX_RESPONSE_NBYTES, 1028 bytes) */
+#define IPC_MSG_MAX_NBYTES			1040U
+
+/* Message types */
+#define IPC_MSG_REQUEST				1U		// Command frame to execute
+#define IPC_MSG_RESPONSE			2U		// Response to a request
+#define IPC_MSG_FRAME				3U		// Deferred response or unsolicited frame
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* A message. Fields other than the data are set by the user of the queue. */
+typedef struct {
+	uint32_t type;					// IPC_MSG_xxx
+	uint32_t seq;					// Request number (also in its response)
+	uint32_t request_id;			// Frame tag (see handleCommand())
+	uint32_t n_bytes;				// Bytes used in data[]
+	uint8_t data[IPC_MSG_MAX_NBYTES];
+} __attribute__((aligned(SPSC_CACHE_LINE))) ipc_msg_t;
+
+/* A queue (ipc_queue_t) and its functions (ipcQueueXxx()). Placed in memory
+ * seen by both cores (see amp.h). */
+SPSC_RING_DEFINE(ipc_queue_t, ipcQueue, ipc_msg_t, IPC_QUEUE_SLOTS)
+
+
+#endif /* SRC_AMP_IPC_QUEUE_H_ */
@@ -64,6 +64,15 @@ static XGpio 		*p_XGpio0Inst = &XGpio0Inst;
 
 
 
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Command handlers, registered with the command handler */
+static uint32_t clearLedsCmd(uint32_t field1, uint32_t field2);
+
+
+
 
 /*---------------------------------------------------------------------------*/
 /*------------------------------- FUNCTIONS ---------------------------------*/
@@ -294,6 +303,49 @@ uint32_t axiGpInRead(AxiGpio0_InPin_t pin){
 }
 
 
+/*****************************************************************************
+ * Function: axiGpio0RegisterCommands()
+ *//**
+ *
+ * @brief		Registers the AXI GPIO commands with the command handler.
+ *
+ * @return		XST_SUCCESS, or XST_FAILURE if registration failed.
+ *
+ * @note		cmdHandlerInit() must be called first.
+ *
+******************************************************************************/
+
+int axiGpio0RegisterCommands(void)
+{
+	return registerCommand(CLEAR_LEDS, clearLedsCmd);
+}
+
+
+
+/*****************************************************************************
+ * Function: clearLedsCmd()
+ *//**
+ *
+ * @brief		CLEAR_LEDS command handler. Used in the shared variable test
+ * 				to clear LED1 and LED2.
+ *
+ * @param[in]	field1, field2: Not used.
+ *
+ * @return		CLEAR_LEDS_RESP.
+ *
+ * @note		None.
+ *
+******************************************************************************/
+
+uint32_t clearLedsCmd(uint32_t field1, uint32_t field2)
+{
+	axiGpOutClear(LED1);
+	axiGpOutClear(LED2);
+
+	return CLEAR_LEDS_RESP;
+}
+
+
 /****** End functions *****/
 
 /****** End of File **********************************************************/
@@ -37,6 +37,9 @@
 
 #include "xgpio.h"
 
+/* Command handler (command registration) */
+#include "../utilities/cmd_handler.h"
+
 
 /*****************************************************************************/
 /************************** Constant Definitions *****************************/
@@ -44,6 +47,9 @@
 
 #define AXI_GPIO0_DEVICE_ID			XPAR_AXI_GPIO_0_DEVICE_ID
 
+/* Response to the CLEAR_LEDS command (added for sw_proj10) */
+#define CLEAR_LEDS_RESP				(0x03030303U)
+
 
 /*****************************************************************************/
 /******************************* Typedefs ************************************/
@@ -101,5 +107,8 @@ void axiGpOutClear(AxiGpio0_OutPin_t pin);
 void axiGpOutToggle(AxiGpio0_OutPin_t pin);
 uint32_t axiGpInRead(AxiGpio0_InPin_t pin);
 
+/* Command handlers */
+int axiGpio0RegisterCommands(void);
+
 
 #endif /* SRC_GPIO_AXI_GPIO0_IF_H_ */
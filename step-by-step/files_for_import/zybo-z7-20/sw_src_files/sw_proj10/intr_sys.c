@@ -134,8 +134,10 @@ int xScuGicInit(void){
 	* -------------------------------------------------------------------- */
 
  	/* Binary point register modified to allow nested interrupts to work.
- 	 * This needs to be done before calling Xil_ExceptionInit(). */
- 	XScuGic_CPUWriteReg(p_XScuGicInst, XSCUGIC_BIN_PT_OFFSET, 0x03);
+ 	 * This needs to be done before calling Xil_ExceptionInit().
+ 	 * (Was 0x03: bits [7:4] only. The preemptive tasks use all of the
+ 	 * priority steps, see scheduler.h.) */
+ 	XScuGic_CPUWriteReg(p_XScuGicInst, XSCUGIC_BIN_PT_OFFSET, GIC_BINARY_POINT);
 
  	/* Initialise exception logic */
  	Xil_ExceptionInit();
@@ -269,6 +271,11 @@ int addUart1ToInterruptSystem(uint32_t p_XUartPsInst)
 									UART1_INTR_PRI,
 									UART1_INTR_TRIG);
 
+#if AMP_MODE
+	/* AMP: UART1 is served by this core (CPU1) only */
+	XScuGic_InterruptMaptoCpu(p_XScuGicInst, AMP_CPU, UART1_INTR_ID);
+#endif
+
 
 	/* Enable the interrupt for Uart1 */
 	XScuGic_Enable(p_XScuGicInst, UART1_INTR_ID);
@@ -281,6 +288,140 @@ int addUart1ToInterruptSystem(uint32_t p_XUartPsInst)
 
 
 
+/*****************************************************************************
+ * Function: addSchedToInterruptSystem()
+ *//**
+ *
+ * @brief
+ *
+ * @details		Connects the SGI of each scheduler level (preemptive tasks)
+ * 				to the interrupt system.
+ * 				Carries out the following steps, for each level:
+ *
+ * 				XScuGic_Connect(): Connect schedSgiHandler(), with the level
+ * 				as its argument.
+ * 				XScuGic_SetPriorityTriggerType(): Sets the priority of the
+ * 				level (SCHED_SGI_PRI()).
+ * 				XScuGic_Enable(): Enables the SGI.
+ *
+ * 				If XScuGic_Connect() is not successful, the routine ends
+ * 				immediately	and returns XST_FAILURE.
+ *
+ *
+ * @return		Returns result of configuration attempt.
+ * 				0L = SUCCESS, 1L = FAILURE
+ *
+ * @note		The SCUGIC must be initialised before calling this function.
+ * 				All levels are connected, whether or not a task uses them.
+ *
+****************************************************************************/
+
+int addSchedToInterruptSystem(void)
+{
+
+	int status = XST_SUCCESS;
+	uint32_t level;
+
+	for (level = 0; level < SCHED_SGI_LEVELS; level++)
+	{
+		// Connect the scheduler SGI handler for this level
+		status = XScuGic_Connect(p_XScuGicInst, SCHED_SGI_BASE + level,
+					  (Xil_ExceptionHandler) schedSgiHandler,
+					  (void *) level);
+		if (status != XST_SUCCESS)
+		{
+			return XST_FAILURE;
+		}
+
+		/* Set priority and trigger */
+		XScuGic_SetPriorityTriggerType(p_XScuGicInst, SCHED_SGI_BASE + level,
+										SCHED_SGI_PRI(level), SCHED_SGI_TRIG);
+
+		/* Enable the SGI */
+		XScuGic_Enable(p_XScuGicInst, SCHED_SGI_BASE + level);
+	}
+
+
+	/* Return initialisation result to calling code */
+	return status;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: addAmpToInterruptSystem()
+ *//**
+ *
+ * @brief
+ *
+ * @details		Connects the AMP SGIs of this core to the interrupt system
+ * 				(see amp.h): the doorbell, and on CPU1 the tick from CPU0.
+ * 				Carries out the following steps, for each SGI:
+ *
+ * 				XScuGic_Connect(): Connect ampDoorbellHandler() or
+ * 				ampTickHandler().
+ * 				XScuGic_SetPriorityTriggerType(): Sets the priority and
+ * 				trigger type of the SGI.
+ * 				XScuGic_Enable(): Enables the SGI.
+ *
+ * 				If XScuGic_Connect() is not successful, the routine ends
+ * 				immediately	and returns XST_FAILURE.
+ *
+ *
+ * @return		Returns result of configuration attempt.
+ * 				0L = SUCCESS, 1L = FAILURE
+ *
+ * @note		The SCUGIC must be initialised before calling this function.
+ * 				SGIs are private to each core, so each core connects its own.
+ *
+****************************************************************************/
+
+int addAmpToInterruptSystem(void)
+{
+
+	int status;
+
+
+	// Connect the doorbell handler
+	status = XScuGic_Connect(p_XScuGicInst, AMP_SGI_DOORBELL,
+				  (Xil_ExceptionHandler) ampDoorbellHandler,
+				  (void *) NULL);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	/* Set priority and trigger, and enable the SGI */
+	XScuGic_SetPriorityTriggerType(p_XScuGicInst, AMP_SGI_DOORBELL,
+									AMP_DOORBELL_PRI, AMP_SGI_TRIG);
+	XScuGic_Enable(p_XScuGicInst, AMP_SGI_DOORBELL);
+
+
+#if AMP_CPU == 1
+	// Connect the tick handler (CPU1)
+	status = XScuGic_Connect(p_XScuGicInst, AMP_SGI_TICK,
+				  (Xil_ExceptionHandler) ampTickHandler,
+				  (void *) NULL);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	/* Set priority and trigger, and enable the SGI */
+	XScuGic_SetPriorityTriggerType(p_XScuGicInst, AMP_SGI_TICK,
+									AMP_TICK_PRI, AMP_SGI_TRIG);
+	XScuGic_Enable(p_XScuGicInst, AMP_SGI_TICK);
+#endif
+
+
+	/* Return initialisation result to calling code */
+	return status;
+
+}
+
+
+
 /*****************************************************************************
  * Function:	enableInterrupts()
  *//**
@@ -319,6 +460,94 @@ void disableInterrupts(void){
 
 
 
+/*****************************************************************************
+ * Function:	enterCritical()
+ *//**
+*
+* @brief		Enters a critical section: raises the GIC priority mask to
+* 				the ceiling priority of the resource to be protected.
+*
+* @details		Only the interrupts that can use the resource (priority at or
+* 				below the ceiling) are held off, so the latency of a higher
+* 				priority interrupt is not increased. If the mask is already at
+* 				or above the ceiling (a nested section), it is left unchanged.
+*
+* 				The mask is read and written with IRQ disabled, and the write
+* 				is completed (dsb, isb) before the section starts, so no
+* 				interrupt at the ceiling is taken after the function returns.
+*
+* @param[in]	uint32_t ceiling: GIC priority (CRIT_CEILING_xxx).
+*
+* @return		The mask to pass to exitCritical().
+*
+* @notes:		Can be called from the main loop, tasks and interrupt handlers.
+* 				The section must be exited in the same context.
+*
+****************************************************************************/
+
+uint32_t enterCritical(uint32_t ceiling){
+
+	uint32_t irq_was_disabled = mfcpsr() & XIL_EXCEPTION_IRQ;
+	uint32_t saved_mask;
+
+	Xil_ExceptionDisable();
+
+	saved_mask = Xil_In32(GIC_CPU_PMR_ADDR);
+	if (ceiling < saved_mask)
+	{
+		Xil_Out32(GIC_CPU_PMR_ADDR, ceiling);
+		dsb();
+		isb();
+	}
+
+	if (irq_was_disabled == 0U)
+	{
+		Xil_ExceptionEnable();
+	}
+
+	return saved_mask;
+
+}
+
+
+
+/*****************************************************************************
+ * Function:	exitCritical()
+ *//**
+*
+* @brief		Leaves a critical section: restores the GIC priority mask
+* 				saved by the matching enterCritical().
+*
+* @param[in]	uint32_t saved_mask: Value returned by enterCritical().
+*
+* @return		None.
+*
+* @notes:		Interrupts held off by the section are taken on return.
+*
+****************************************************************************/
+
+void exitCritical(uint32_t saved_mask){
+
+	uint32_t irq_was_disabled = mfcpsr() & XIL_EXCEPTION_IRQ;
+
+	Xil_ExceptionDisable();
+
+	if (Xil_In32(GIC_CPU_PMR_ADDR) != saved_mask)
+	{
+		Xil_Out32(GIC_CPU_PMR_ADDR, saved_mask);
+		dsb();
+		isb();
+	}
+
+	if (irq_was_disabled == 0U)
+	{
+		Xil_ExceptionEnable();
+	}
+
+}
+
+
+
 /****** End functions *****/
 
 /****** End of File **********************************************************/
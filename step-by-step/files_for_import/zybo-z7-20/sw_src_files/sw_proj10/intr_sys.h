@@ -39,10 +39,13 @@
 /* Xilinx low-level */
 #include "xscugic.h"
 #include "xil_exception.h"
+#include "xil_io.h"
+#include "xpseudo_asm.h"
 
 /* Must also include any files for drivers which will be added to intr sys: */
 #include "uart/ps7_uart1_if.h"
 #include "timers/ttc0_if.h"
+#include "amp/amp.h"
 
 
 /*****************************************************************************/
@@ -77,6 +80,40 @@
 #define TTC0_INTR_PRI				(0xA0) // Higher priority than UART
 #define TTC0_INTR_TRIG				(0x01) // Active-high Level Sensitive
 
+/* Scheduler SGIs (preemptive tasks): SCHED_SGI_PRI(level), 0xC0 - 0xE8,
+ * lower priority than UART (see scheduler.h) */
+#define SCHED_SGI_TRIG				(0x02) // Rising edge (SGIs are always edge)
+
+/* AMP SGIs (see amp.h). The doorbell only wakes the main loop: just below
+ * UART1. The tick of CPU1 takes the place of TTC0 there. */
+#define AMP_DOORBELL_PRI			(0xB8)
+#define AMP_TICK_PRI				(0xA0)
+#define AMP_SGI_TRIG				(0x02) // Rising edge
+
+/* Binary point: priority bits [7:3] (all bits implemented by the GIC) are
+ * group priority, so that each priority step of 0x08 can preempt */
+#define GIC_BINARY_POINT			(0x02)
+
+
+/* === Critical sections === */
+/*	enterCritical(ceiling) raises the GIC CPU priority mask (ICCPMR) to the
+*	ceiling priority of a resource: the highest priority (lowest value) of
+*	any code that uses it. Interrupts at the ceiling or below are held off;
+*	those above it (e.g. TTC0) still preempt. exitCritical() restores the
+*	mask returned by enterCritical(), so critical sections can be nested:
+*	an inner section never lowers the mask of an outer one.
+*
+*	The mask is per CPU: it does not protect data shared with the other core
+*	(see amp.h). */
+
+/* GIC CPU interface priority mask register (banked per CPU) */
+#define GIC_CPU_PMR_ADDR			(XPAR_PS7_SCUGIC_0_BASEADDR + XSCUGIC_CPU_PRIOR_OFFSET)
+
+/* Ceilings */
+#define CRIT_CEILING_UART1			UART1_INTR_PRI	// Shared with the UART1 ISR (and lower)
+#define CRIT_CEILING_TTC0			TTC0_INTR_PRI	// Shared with the TTC0 ISR (and lower)
+#define CRIT_CEILING_ALL			(0x00)			// Every interrupt
+
 
 
 
@@ -111,11 +148,17 @@ int xScuGicInit(void);
 /* Interrupt configuration */
 int addTtc0ToInterruptSystem(uint32_t p_Xttc0Inst);
 int addUart1ToInterruptSystem(uint32_t p_XUartPsInst);
+int addSchedToInterruptSystem(void);
+int addAmpToInterruptSystem(void);
 
 
 /* Interface functions */
 void enableInterrupts(void);
 void disableInterrupts(void);
 
+/* Critical sections */
+uint32_t enterCritical(uint32_t ceiling);
+void exitCritical(uint32_t saved_mask);
+
 
 #endif /* SRC_INTR_SYS_H_ */
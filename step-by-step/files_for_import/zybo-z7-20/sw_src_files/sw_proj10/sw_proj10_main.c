@@ -52,8 +52,12 @@ int main(void)
 	printf("----------- Zynq Fundamentals Software Project 10 -----------\n\r");
 	printf("------------------------------------------------------------\n\r");
 	printf("Title: Nested Interrupts; Shared Variables\r\n");
-	printf("Architecture: FG/BG Polled State Machine.\r\n");
-	printf("Timing: Triple Timer Counter 0, Wave 0.\r\n\r\n");
+	printf("Architecture: FG/BG Time-Triggered Scheduler.\r\n");
+	printf("Timing: Triple Timer Counter 0, Wave 0.\r\n");
+#if AMP_MODE
+	printf("AMP: CPU%d (%s).\r\n", AMP_CPU, (AMP_CPU == 0) ? "real time" : "comms");
+#endif
+	printf("\r\n");
 #endif
 
 
@@ -71,6 +75,16 @@ int main(void)
 		/* Run initialisation */
 		init_status = sys_init();
 
+#if AMP_COMMS_IMAGE
+		/* CPU1 (AMP): no LEDs or WDT here; CPU0 shows the system state */
+		if (init_status != XST_SUCCESS){
+			#if MAIN_DEBUG
+				printf("\n\r!!! CPU1 INITIALIZATION FAILED !!!\n\r");
+			#endif
+			while(1)
+				{}
+		}
+#else
 		if (init_status == XST_SUCCESS){
 			axiGpOutSet(LED0);
 			#if MAIN_DEBUG
@@ -94,12 +108,13 @@ int main(void)
 				{}
 			}
 		}
+#endif
 
 	// ********************************************************************************* //
-	// *****   MAIN PROGRAM [TASK STATE MACHINE ARCHITECTURE] *****
+	// *****   MAIN PROGRAM [TIME-TRIGGERED SCHEDULER] *****
 	// ********************************************************************************* //
 
-#if MAIN_DEBUG
+#if MAIN_DEBUG && !AMP_COMMS_IMAGE
 	printf("\n\rRunning main program; LED4 should be toggling.\n\r");
 #endif
 
@@ -108,18 +123,9 @@ int main(void)
 	for(;;) // Infinite loop
 	{
 
-		/* Use to slow down LED4 toggle rate, when loop rate is very fast */
-		static uint32_t led4_count = 0U;
-
-		/* Flags for WDT to know that task completed */
-		static uint32_t task1_complete = 0U;
-		static uint32_t task2_complete = 0U;
-
 		static enum {
 			INIT,
-			TASK1,
-			TASK2,
-			SERVICE_WDT
+			RUN
 		} state = INIT;
 
 
@@ -127,73 +133,52 @@ int main(void)
 		switch (state) {
 			case INIT:
 				enableInterrupts();
+#if !AMP_COMMS_IMAGE
 				startTtc0();
-				task1_complete = 0U;
-				task2_complete = 0U;
-				state = TASK1;
+#endif
+				state = RUN;
 				break;
 
 
-		/* ----- (2) RUN TASKS 1 AND 2 ----------------------------------- */
-		/* For each task case:
-		 * (a) Wait for task trigger signal.
-		 * (b) Call the task.
-		 * (c) When task returns, set 'taskX_complete' signal.
-		 * (d) Set the next state.*/
-
-		case TASK1:
-			if (getTask1TriggerState() == 1U)
-			{
-				task1();
-				task1_complete = 1U;
-				state = TASK2;
-			}
-			break;
-
-
-		case TASK2:
-			if (getTask2TriggerState() == 1U)
-			{
-				task2();
-				task2_complete = 1U;
-				state = SERVICE_WDT;
-			}
-			break;
-
-
-
-			/* ----- (3) SERVICE WDT----------------------------------------- */
-			/* Main aim is to check that task1 and task2 have completed.
-			 * If they have, the watchdog will be serviced, the task_complete
-			 * signals will be cleared, and the sequencer will go back to
-			 * TASK1 state. If the tasks have not completed,then the sequencer
-			 * stays in this state, the watchdog will not be serviced, and the
-			 * system eventually resets.
-			 *
-			 * The LED4 count logic is used to slow the visible LED toggle rate
-			 * when the system is running very fast.  */
-
-			case SERVICE_WDT:
-				psGpOutSet(PS_GP_OUT5);			/// TEST SIGNAL
-
-				if ( (task1_complete == 1U) && (task2_complete == 1U) )
+		/* ----- (2) RUN THE SCHEDULER ----------------------------------- */
+		/* (a) For each TTC0 tick, run the tasks that are due, in priority
+		 *     order (see the task table in tasks.c). The lowest-priority
+		 *     task services the watchdog, so if any task does not complete,
+		 *     the system eventually resets.
+		 * (b) When no tick is waiting, execute one command from the host
+		 *     (received into the UART1 receive ring by the ISR).
+		 * (c) When there is nothing to do, sleep (WFI) until the next
+		 *     interrupt: TTC0 tick or UART1 (see idle.h).
+		 * AMP (see amp.h): CPU0 executes the commands passed on by CPU1
+		 * in (b), and is woken by the doorbell instead of UART1. CPU1 runs
+		 * the comms block only: frames from CPU0 and the per-tick comms
+		 * services, then commands from the host. */
+			case RUN:
+#if AMP_COMMS_IMAGE
+				if (ampServiceComms() == 0U)
 				{
-					led4_count++;
-					if (led4_count == LED4_TOGGLE_COUNT)
+					if (uart1ServiceCommands() == 0U)
 					{
-						psGpOutToggle(LED4);
-						led4_count = 0;
+						idleWait(ampCommsWorkPending);
 					}
-					task1_complete = 0U;
-					task2_complete = 0U;
-					/* --- 'TICKLE' WATCHDOG --- */
-					restartScuWdt();
-					state = TASK1;
 				}
-				psGpOutClear(PS_GP_OUT5);	/// TEST SIGNAL
+#else
+				if (schedDispatch() == 0U)
+				{
+#if AMP_MODE
+					if (ampServiceRequests() == 0U)
+#else
+					if (uart1ServiceCommands() == 0U)
+#endif
+					{
+						idleWait(tasksWorkPending);
+					}
+				}
+#endif
 				break;
 
 			} /* End switch */
+
 	}
 
 		return 0;
@@ -51,6 +51,120 @@
 static uint32_t volatile g_task1_shared_var;
 static uint32_t volatile g_task2_shared_var;
 
+/* Software timers */
+static sw_timer_t		HeartbeatTimer;
+
+
+
+/* Task table. Period and offset are in scheduler ticks (TTC0 cycles, 50us);
+ * priority 0 is the highest. taskServiceWdt() has the lowest priority, so it
+ * only runs once every other task due in the tick has completed.
+ * task1/task2 are preemptive: they run in the SGI handlers of levels 0 and 1
+ * (see scheduler.h), so a long command or service in the main loop does not
+ * delay them, and task1 preempts task2.
+ * Late runs of task1/task2 raise the alarm output (see taskAlarm()). The
+ * services and the software timers catch up, so that tick-based timeouts
+ * stay correct; the watchdog service only needs its latest run. */
+static const sched_task_t TaskTable[] =
+{
+	/*	function			period					offset	priority	policy */
+	{	task1,				1U,						0U,		0U,			SCHED_CATCH_UP | SCHED_ALARM | SCHED_PREEMPT },
+	{	task2,				1U,						0U,		1U,			SCHED_CATCH_UP | SCHED_ALARM | SCHED_PREEMPT },
+	{	taskServices,		1U,						0U,		2U,			SCHED_CATCH_UP },
+	{	taskTimers,			1U,						0U,		3U,			SCHED_CATCH_UP },
+	{	taskServiceWdt,		1U,						0U,		4U,			SCHED_SKIP },
+};
+
+#define N_TASKS		(sizeof(TaskTable) / sizeof(TaskTable[0]))
+
+
+
+/*****************************************************************************
+ * Function: tasksInit()
+ *//**
+ *
+ * @brief		Passes the task table and the alarm handler to the scheduler,
+ * 				and starts the software timers.
+ *
+ * @return		XST_SUCCESS, or XST_FAILURE if the table is not valid
+ * 				(see schedInit()).
+ *
+ * @note		Must be called before TTC0 is started.
+ *
+******************************************************************************/
+
+int tasksInit(void)
+{
+
+	int status;
+
+	schedSetAlarm(taskAlarm);
+	status = schedInit(TaskTable, N_TASKS);
+
+	swTimerInit(&HeartbeatTimer, timerHeartbeat, NULL);
+	status |= swTimerStart(&HeartbeatTimer, LED4_TOGGLE_PERIOD, LED4_TOGGLE_PERIOD);
+
+	return status;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: taskAlarm()
+ *//**
+ *
+ * @brief		Scheduler alarm handler: sets TASK_ALARM_PIN on a late start
+ * 				or overrun of a SCHED_ALARM task, and clears it when the host
+ * 				clears the task profiles.
+ *
+ * @param[in]	uint32_t id:	Task ID (SCHED_ALL for SCHED_EVENT_CLEAR).
+ * @param[in]	uint32_t event:	SCHED_EVENT_xxx.
+ *
+ * @return		None.
+ *
+ * @note		The pin stays set until cleared, so that a single event can be
+ * 				caught with a scope or logic analyzer trigger.
+ *
+******************************************************************************/
+
+void taskAlarm(uint32_t id, uint32_t event)
+{
+	if (event == SCHED_EVENT_CLEAR)
+	{
+		psGpOutClear(TASK_ALARM_PIN);
+	}
+	else
+	{
+		psGpOutSet(TASK_ALARM_PIN);
+	}
+}
+
+
+
+/*****************************************************************************
+ * Function: tasksWorkPending()
+ *//**
+ *
+ * @brief		Checks whether the main loop has work waiting: a tick to
+ * 				dispatch, or a command to execute.
+ *
+ * @return		1 if there is work waiting, otherwise 0.
+ *
+ * @note		Passed to idleWait(), which calls it with interrupts disabled
+ * 				before putting the core to sleep.
+ *
+******************************************************************************/
+
+uint32_t tasksWorkPending(void)
+{
+#if AMP_MODE
+	return (schedPending() | ampRequestsPending());
+#else
+	return (schedPending() | uart1WorkPending());
+#endif
+}
+
 
 
 /*****************************************************************************
@@ -58,12 +172,14 @@ static uint32_t volatile g_task2_shared_var;
  *//**
  *
  * @brief		Task has been modified for a shared variable test. Normally,
- * 				interrupts should be disabled at the start of the task so that
+ * 				a critical section is entered at the start of the task so that
  * 				the shared variable cannot be 'trampled on' by other code that
- * 				accesses the shared variable. If running a test, though, then
- * 				interrupts remain enabled, and external code (the UART handler)
- * 				might also write to the shared variable. If this happens, then
- * 				LED1 will be turned on to indicated the undesired access.
+ * 				accesses the shared variable. The priority mask is raised to
+ * 				the ceiling of the variable (TASK_SHARED_VAR_CEILING), so the
+ * 				UART handler is held off but TTC0 is not. If running a test,
+ * 				though, then the mask is not raised, and external code (the
+ * 				UART handler) might also write to the shared variable. If this
+ * 				happens, then LED1 will be turned on to indicated the undesired access.
  *
  * 				This task sets the shared variable to 0xA5A5_A5A5 soon after
  * 				the task starts. A small dummy delay is then run.
@@ -80,11 +196,11 @@ static uint32_t volatile g_task2_shared_var;
 void task1(void)
 {
 
-	/* 1. Disable interrupts to protect shared variable. */
+	/* 1. Enter a critical section to protect shared variable. */
 	/* If running the shared variable test, this line will not be executed,
 	 * meaning that external code might overwrite the variable. */
 #if !TASK1_SHARED_VAR_TEST
-	disableInterrupts();
+	uint32_t saved_mask = enterCritical(TASK_SHARED_VAR_CEILING);
 #endif
 
 	psGpOutSet(PS_GP_OUT3);		/// TEST SIGNAL: ENTERING TASK 1
@@ -113,10 +229,10 @@ void task1(void)
 	psGpOutClear(PS_GP_OUT3);	/// TEST SIGNAL: LEAVING TASK 1
 
 
-	/* 5. Re-enable interrupts when task is finished. */
+	/* 5. Leave the critical section when task is finished. */
 	/* If running the shared variable test, this line will not be executed. */
 #if !TASK1_SHARED_VAR_TEST
-	enableInterrupts();
+	exitCritical(saved_mask);
 #endif
 
 
@@ -131,12 +247,14 @@ void task1(void)
  *//**
  *
  * @brief		Task has been modified for a shared variable test. Normally,
- * 				interrupts should be disabled at the start of the task so that
+ * 				a critical section is entered at the start of the task so that
  * 				the shared variable cannot be 'trampled on' by other code that
- * 				accesses the shared variable. If running a test, though, then
- * 				interrupts remain enabled, and external code (the UART handler)
- * 				might also write to the shared variable. If this happens, then
- * 				LED2 will be turned on to indicated the undesired access.
+ * 				accesses the shared variable. The priority mask is raised to
+ * 				the ceiling of the variable (TASK_SHARED_VAR_CEILING), so the
+ * 				UART handler is held off but TTC0 is not. If running a test,
+ * 				though, then the mask is not raised, and external code (the
+ * 				UART handler) might also write to the shared variable. If this
+ * 				happens, then LED2 will be turned on to indicated the undesired access.
  *
  * 				This task sets the shared variable to 0xA5A5_A5A5 soon after
  * 				the task starts. A small dummy delay is then run.
@@ -153,11 +271,11 @@ void task1(void)
 void task2(void)
 {
 
-	/* 1. Disable interrupts to protect shared variable. */
+	/* 1. Enter a critical section to protect shared variable. */
 	/* If running the shared variable test, this line will not be executed,
 	 * meaning that external code might overwrite the variable. */
 #if !TASK2_SHARED_VAR_TEST
-	disableInterrupts();
+	uint32_t saved_mask = enterCritical(TASK_SHARED_VAR_CEILING);
 #endif
 
 	psGpOutSet(PS_GP_OUT4);		/// TEST SIGNAL: ENTERING TASK 2
@@ -186,16 +304,112 @@ void task2(void)
 	psGpOutClear(PS_GP_OUT4);	/// TEST SIGNAL: LEAVING TASK 2
 
 
-	/* 5. Re-enable interrupts when task is finished. */
+	/* 5. Leave the critical section when task is finished. */
 	/* If running the shared variable test, this line will not be executed. */
 #if !TASK2_SHARED_VAR_TEST
-	enableInterrupts();
+	exitCritical(saved_mask);
+#endif
+
+
+}
+
+
+/*****************************************************************************
+ * Function: taskServices()
+ *//**
+ *
+ * @brief		Runs the once-per-tick services of the command and comms
+ * 				modules.
+ *
+ * @return		None.
+ *
+ * @note		None.
+ *
+******************************************************************************/
+
+void taskServices(void)
+{
+	waitForTick();		// WAIT_FOR conditions: once per TTC0 cycle
+	seqTick();			// Sequencer programs armed for the task slot
+	telemTick();		// Telemetry subscriptions: sample and push
+#if !AMP_MODE
+	uart1BaudTick();	// Baud rate negotiation (AMP: on CPU1, see ampServiceComms())
 #endif
+	logDrain();			// Deferred log: push pending records to the host
+}
+
+
+
+/*****************************************************************************
+ * Function: taskTimers()
+ *//**
+ *
+ * @brief		Runs the software timers: the callbacks of the timers that
+ * 				expire in this tick are called from here.
+ *
+ * @return		None.
+ *
+ * @note		Runs every tick, and catches up, so that no tick is lost.
+ *
+******************************************************************************/
+
+void taskTimers(void)
+{
+	swTimerTick();
+}
+
 
 
+/*****************************************************************************
+ * Function: timerHeartbeat()
+ *//**
+ *
+ * @brief		Toggles LED4 to show that the scheduler is running.
+ *
+ * @param[in]	void *p_arg:	Not used.
+ *
+ * @return		None.
+ *
+ * @note		Callback of a periodic software timer (LED4_TOGGLE_PERIOD).
+ *
+******************************************************************************/
+
+void timerHeartbeat(void *p_arg)
+{
+	psGpOutToggle(LED4);
+}
+
+
+
+/*****************************************************************************
+ * Function: taskServiceWdt()
+ *//**
+ *
+ * @brief		Services the watchdog.
+ *
+ * @details		This task has the lowest priority, so it only runs when every
+ * 				other task due in the tick has returned. If a task does not
+ * 				complete, the watchdog is not serviced and the system
+ * 				eventually resets.
+ *
+ * @return		None.
+ *
+ * @note		None.
+ *
+******************************************************************************/
+
+void taskServiceWdt(void)
+{
+	psGpOutSet(PS_GP_OUT5);			/// TEST SIGNAL
+
+	/* --- 'TICKLE' WATCHDOG --- */
+	restartScuWdt();
+
+	psGpOutClear(PS_GP_OUT5);		/// TEST SIGNAL
 }
 
 
+
 /* === ADDED SW_PROJ10 === */
 
 /*****************************************************************************
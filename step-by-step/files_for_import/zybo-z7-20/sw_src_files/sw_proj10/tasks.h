@@ -39,6 +39,15 @@
 // Interface files
 #include "gpio/ps7_gpio_if.h"
 #include "gpio/axi_gpio0_if.h"
+#include "wdt/scuwdt_if.h"
+#include "uart/ps7_uart1_if.h"
+#include "utilities/wait_for.h"
+#include "utilities/sequencer.h"
+#include "utilities/telemetry.h"
+#include "utilities/logger.h"
+#include "utilities/scheduler.h"
+#include "utilities/idle.h"
+#include "utilities/sw_timer.h"
 
 
 /*****************************************************************************/
@@ -49,17 +58,52 @@
 // #define LED2_TOGGLE_COUNT			2000U
 
 
+/* Shared variable test: while either switch is set, the UART1 ISR 'tramples
+ * on' both shared variables on every RX interrupt (see UartIntrHandler()).
+ * A task with its switch set does not enter its critical section, so the
+ * write can land while it runs (its LED turns on); a task with its switch
+ * clear holds the ISR off, and its LED stays off. Single-core build only:
+ * in the AMP build the UART1 ISR runs on CPU1. */
 #define TASK1_SHARED_VAR_TEST 		1
 #define TASK2_SHARED_VAR_TEST 		0
 
+/* Ceiling of the shared variables (see enterCritical()): they are written
+ * by the UART1 ISR in the test, so only UART1 and lower priorities are
+ * held off; TTC0 is not delayed by task1/task2. */
+#define TASK_SHARED_VAR_CEILING		CRIT_CEILING_UART1
+
+
+/* LED4 toggle period, in scheduler ticks (0.4 s; software timer) */
+#define LED4_TOGGLE_PERIOD			8000U
+
+/* Set on a late start or overrun of task1/task2 (see taskAlarm()). A pin
+ * that no test signal drives (MIO11, PMOD JF pin 3), so that the alarm
+ * stays latched until the host clears it. */
+#define TASK_ALARM_PIN				PS_GP_OUT2
+
 
 /*****************************************************************************/
 /************************** Function Prototypes ******************************/
 /*****************************************************************************/
 /*=== Task logic === */
+/* Task table (see tasks.c) */
+int tasksInit(void);
+
 /* Tasks */
 void task1(void);
 void task2(void);
+void taskServices(void);
+void taskTimers(void);
+void taskServiceWdt(void);
+
+/* Software timer callbacks */
+void timerHeartbeat(void *p_arg);
+
+/* Scheduler alarm handler */
+void taskAlarm(uint32_t id, uint32_t event);
+
+/* Work waiting for the main loop (see idleWait()) */
+uint32_t tasksWorkPending(void);
 
 
 
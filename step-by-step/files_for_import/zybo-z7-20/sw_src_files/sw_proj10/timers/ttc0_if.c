@@ -60,11 +60,19 @@
 static XTtcPs		XTtc0PsInst;
 static XTtcPs 		*p_XTtc0PsInst = &XTtc0PsInst;
 
+/* Next MATCH0 value, and the remainder carried to the next period, in
+ * 1/SCHED_TICK_RATE_HZ counts (TTC0_TICK_MATCH_ADVANCE) */
+static uint32_t		ttc0_match = 0U;
+static uint32_t		ttc0_match_rem = 0U;
 
-/* Task trigger signals; Scope is local to this file.
- * Accessor functions are used to give access to other files. */
-static uint32_t volatile trigger_task1;
-static uint32_t volatile trigger_task2;
+/* Tick phase error (written by the ISR, read under the seqlock) */
+static ttc0_phase_t	Ttc0Phase;
+static ttc0_phase_t	*p_Ttc0Phase = &Ttc0Phase;
+static seqlock_t	Ttc0PhaseLock;
+
+/* Periods elapsed since the last tick measured: 1, plus any missed ticks
+ * (TTC0_TICK_MATCH_ADVANCE) */
+static uint32_t		ttc0_periods = 1U;
 
 
 /****************************************************************************/
@@ -77,6 +85,12 @@ static uint32_t volatile trigger_task2;
 /************************** Function Prototypes ******************************/
 /*****************************************************************************/
 
+/* Functions internal to this file */
+static uint32_t advanceTtc0Match(void);
+static void updateTtc0Phase(XTime t_tick, uint32_t n_periods);
+
+/* Command handlers */
+static uint32_t ttc0TickStatsCmd(uint32_t field1, uint32_t field2);
 
 
 
@@ -170,16 +184,31 @@ int xTtc0Init(uint32_t *p_inst) {
 	* -------------------------------------------------------------------- */
 	/* Configuration steps are:
 	* (1) Set clock control options (prescaler)
-	* (2) Set Match mode.
-	* (3) Set MATCH0 value to TASK1_MATCH.
-	* (4) Set MATCH1 value to TASK2_MATCH.
-	* (5) Enable MATCH0 and MATCH1 interrupts. */
+	* (2) Set the mode for TTC0_TICK_MODE (see ttc0_if.h):
+	* 		MATCH_ADVANCE: Match mode, MATCH0 = first period.
+	* 		INTERVAL: Interval mode, interval = SCHED_TICK_INTERVAL.
+	* 		MATCH_RESET: Match mode, MATCH0 = SCHED_TICK_MATCH.
+	* (3) Enable the MATCH0 or interval interrupt.
+	* (4) Take the first tick as the phase reference. */
 	XTtcPs_SetPrescaler(p_XTtc0PsInst, PRESCALER_VALUE);
+
+#if (TTC0_TICK_MODE == TTC0_TICK_MATCH_ADVANCE)
 	XTtcPs_SetOptions(p_XTtc0PsInst, XTTCPS_OPTION_MATCH_MODE);
-	XTtcPs_SetMatchValue(p_XTtc0PsInst, 0, TASK1_MATCH);
-	XTtcPs_SetMatchValue(p_XTtc0PsInst, 1, TASK2_MATCH);
-	XTtcPs_EnableInterrupts(p_XTtc0PsInst, XTTCPS_IXR_MATCH_0_MASK
-										| XTTCPS_IXR_MATCH_1_MASK );
+	ttc0_match = 0U;
+	ttc0_match_rem = 0U;
+	(void)advanceTtc0Match();
+	XTtcPs_EnableInterrupts(p_XTtc0PsInst, XTTCPS_IXR_MATCH_0_MASK);
+#elif (TTC0_TICK_MODE == TTC0_TICK_INTERVAL)
+	XTtcPs_SetOptions(p_XTtc0PsInst, XTTCPS_OPTION_INTERVAL_MODE);
+	XTtcPs_SetInterval(p_XTtc0PsInst, SCHED_TICK_INTERVAL);
+	XTtcPs_EnableInterrupts(p_XTtc0PsInst, XTTCPS_IXR_INTERVAL_MASK);
+#else
+	XTtcPs_SetOptions(p_XTtc0PsInst, XTTCPS_OPTION_MATCH_MODE);
+	XTtcPs_SetMatchValue(p_XTtc0PsInst, 0, SCHED_TICK_MATCH);
+	XTtcPs_EnableInterrupts(p_XTtc0PsInst, XTTCPS_IXR_MATCH_0_MASK);
+#endif
+
+	p_Ttc0Phase->restart = 1U;
 
 
 	/* === END CONFIGURATION SEQUENCE ===  */
@@ -200,27 +229,31 @@ int xTtc0Init(uint32_t *p_inst) {
  *//**
  *
  * @brief		Interrupt handler for the TTC0 Timer. Used in this project
- * 				for triggering tasks in the main code.
+ * 				to generate the scheduler tick.
  *
  *
- * @details		The basic aim of this function is to assert trigger_task1
- * 				and trigger_task2 at the correct timing intervals. TTC0 is
- * 				configured in Match mode, and match registers 0 and 1 are used:
- * 				MATCH0 = trigger task 1.
- * 				MATCH1 = trigger task 2.
+ * @details		The tick is the MATCH0 interrupt, or the interval interrupt
+ * 				in TTC0_TICK_INTERVAL mode (see ttc0_if.h).
  *
  * 				The basic flow every time an interrupt occurs is:
- * 				(1) Read the TTC0 interrupt status.
- * 				(2) Clear the interrupt.
- * 				(3) If interrupt status = MATCH0:
- * 						(a) Assert trigger_task1.
- * 				(4) Else if interrupt status = MATCH1:
- * 						(a) Assert trigger_task2.
- * 						(b) Reset TTC0 count so that the task sequence can
- * 							start again.
- *
- *
- * @note		Match values are defined in ttc0_if.h
+ * 				(1) Read the TTC0 count and the Global Timer.
+ * 				(2) Read the TTC0 interrupt status.
+ * 				(3) Clear the interrupt.
+ * 				(4) If interrupt status = tick:
+ * 						(a) Work out the tick latency: the counts since the
+ * 							tick (idleTickLatency()).
+ * 						(b) Update the phase error.
+ * 						(c) Count a tick (schedTick()).
+ * 						(d) Set up the next tick: move MATCH0 on one period
+ * 							(MATCH_ADVANCE), or reset the TTC0 count
+ * 							(MATCH_RESET). In INTERVAL mode, the counter
+ * 							has restarted by itself.
+ * 						(e) AMP: ring the tick SGI of CPU1 (see amp.h).
+ *
+ * 				The tasks themselves are run by schedDispatch() in the main
+ * 				loop, so this handler does not change when tasks are added.
+ *
+ * @note		Tick period and mode are defined in ttc0_if.h
  *
 ****************************************************************************/
 
@@ -229,34 +262,66 @@ void xTtc0IntrHandler(void *CallBackRef){
 
 	psGpOutSet(PS_GP_OUT0); /// SET TEST SIGNAL: TIMNG INTERRUPT ///
 
-	trigger_task1 = 0U;
-	trigger_task2 = 0U;
-
 
+	/* Read the count and the time first, to measure the latency and the
+	 * phase of the tick */
+	uint32_t count = XTtcPs_GetCounterValue((XTtcPs *)CallBackRef);
+	XTime t_isr;
+	XTime_GetTime(&t_isr);
 
 	/* Read and clear TTC0 interrupts */
 	uint32_t status_event = 0U;
 	status_event = XTtcPs_GetInterruptStatus((XTtcPs *)CallBackRef);
 	XTtcPs_ClearInterruptStatus((XTtcPs *)CallBackRef, status_event);
 
-	/* Assert trigger_taskX depending on the MATCH interrupt. */
+	/* Count a scheduler tick on the MATCH (or interval) interrupt. */
 
+#if (TTC0_TICK_MODE == TTC0_TICK_INTERVAL)
+	if (0 != (XTTCPS_IXR_INTERVAL_MASK & status_event))
+#else
 	if (0 != (XTTCPS_IXR_MATCH_0_MASK & status_event))
+#endif
 	{
-		psGpOutSet(PS_GP_OUT1); 	/// SET TEST SIGNAL: TRIGGER TASK 1 ///
-
-		trigger_task1 = 1U;
-
-		psGpOutClear(PS_GP_OUT1);   /// CLEAR TEST SIGNAL: TRIGGER TASK 1 ///
-	}
-	else if (0 != (XTTCPS_IXR_MATCH_1_MASK & status_event))
-	{
-		psGpOutSet(PS_GP_OUT2); 	/// SET TEST SIGNAL: TRIGGER TASK 2 ///
-
-		trigger_task2 = 1U;
+		psGpOutSet(PS_GP_OUT1); 	/// SET TEST SIGNAL: SCHEDULER TICK ///
+
+		/* Counts since the tick */
+		uint32_t latency;
+#if (TTC0_TICK_MODE == TTC0_TICK_MATCH_ADVANCE)
+		latency = (count - ttc0_match) & TTC0_COUNT_MASK;
+#elif (TTC0_TICK_MODE == TTC0_TICK_INTERVAL)
+		latency = count;
+#else
+		latency = (count - SCHED_TICK_MATCH) & TTC0_COUNT_MASK;
+#endif
+
+		idleTickLatency(latency);
+		updateTtc0Phase(t_isr - ((XTime)latency * TTC0_GT_RATIO), ttc0_periods);
+		ttc0_periods = 1U;
+		schedTick();
+
+#if (TTC0_TICK_MODE == TTC0_TICK_MATCH_ADVANCE)
+		/* A match that has already passed will not interrupt: count the
+		 * missed ticks here, so that the scheduler stays on time. */
+		uint32_t missed = advanceTtc0Match();
+		while (missed > 0U)
+		{
+			seqlockWriteBegin(&Ttc0PhaseLock);
+			p_Ttc0Phase->missed++;
+			seqlockWriteEnd(&Ttc0PhaseLock);
+			ttc0_periods++;
+			schedTick();
+			missed--;
+		}
+#elif (TTC0_TICK_MODE == TTC0_TICK_MATCH_RESET)
 		resetTtc0();
+#endif
 
-		psGpOutClear(PS_GP_OUT2);   /// CLEAR TEST SIGNAL: TRIGGER TASK 1 ///
+#if AMP_MODE
+		/* Tick of the comms core (CPU1) */
+		ampRing(1U, AMP_SGI_TICK);
+#endif
+
+		psGpOutClear(PS_GP_OUT1);   /// CLEAR TEST SIGNAL: SCHEDULER TICK ///
 	}
 	else
 		{ }
@@ -310,40 +375,222 @@ void resetTtc0(void)
 
 
 /*****************************************************************************
- * Function: getTask1TriggerState()
+ * Function: ttc0RegisterCommands()
  *//**
  *
- * @brief		Accessor function to allow top-level main() code to read
- * 				global trigger_task1 status.
+ * @brief		Registers GET_TICK_STATS with the command handler.
  *
- * @return		Current value of trigger state.
+ * @return		XST_SUCCESS, or XST_FAILURE if registration failed.
  *
- * @note		None.
+ * @note		cmdHandlerInit() must be called first.
  *
-******************************************************************************/
+****************************************************************************/
 
-uint32_t getTask1TriggerState(void)
+int ttc0RegisterCommands(void)
 {
-	return trigger_task1;
+	return registerCommand(GET_TICK_STATS, ttc0TickStatsCmd);
 }
 
 
 
 /*****************************************************************************
- * Function: getTask2TriggerState()
+ * Function: advanceTtc0Match()
  *//**
  *
- * @brief		Accessor function to allow top-level main() code to read
- * 				trigger_task2 status.
+ * @brief		Moves MATCH0 on by one tick period (TTC0_TICK_MATCH_ADVANCE).
  *
- * @return		Current value of trigger state.
+ * @details		The period is SCHED_TICK_COUNTS, plus one count whenever the
+ * 				remainder carried from the previous periods reaches a whole
+ * 				count, so that the mean period is exact.
  *
- * @note		None.
+ * 				If the counter has already passed the new match value (the
+ * 				ISR ran more than one period late), no interrupt would come
+ * 				for it: the match is moved on again, and the tick is
+ * 				reported as missed.
  *
-******************************************************************************/
-uint32_t getTask2TriggerState(void)
+ * @return		Number of ticks missed (normally 0).
+ *
+ * @note		Called from xTtc0Init() and the TTC0 ISR.
+ *
+****************************************************************************/
+
+uint32_t advanceTtc0Match(void)
 {
-	return trigger_task2;
+
+	uint32_t missed = 0U;
+	uint32_t old_match;
+	uint32_t period;
+
+	for (;;)
+	{
+		old_match = ttc0_match;
+
+		period = SCHED_TICK_COUNTS;
+		ttc0_match_rem += SCHED_TICK_COUNTS_REM;
+		if (ttc0_match_rem >= SCHED_TICK_RATE_HZ)
+		{
+			ttc0_match_rem -= SCHED_TICK_RATE_HZ;
+			period++;
+		}
+
+		ttc0_match = (old_match + period) & TTC0_COUNT_MASK;
+		XTtcPs_SetMatchValue(p_XTtc0PsInst, 0, ttc0_match);
+
+		/* Still ahead of the counter: the match will interrupt */
+		if (((XTtcPs_GetCounterValue(p_XTtc0PsInst) - old_match) & TTC0_COUNT_MASK) <= period)
+		{
+			break;
+		}
+		missed++;
+	}
+
+	return missed;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: updateTtc0Phase()
+ *//**
+ *
+ * @brief		Updates the phase error with the time of a tick.
+ *
+ * @param[in]	XTime t_tick:		Time of the tick (Global Timer).
+ * @param[in]	uint32_t n_periods:	Tick periods since the last tick measured.
+ *
+ * @details		The ideal time is moved on by n_periods x 50us, in TTC0
+ * 				counts (whole counts plus remainder, as for the match value).
+ * 				The first tick after start-up or TTC0_STATS_CLEAR is taken as
+ * 				the reference (phase error 0).
+ *
+ * @return		None.
+ *
+ * @note		Called from the TTC0 ISR.
+ *
+****************************************************************************/
+
+void updateTtc0Phase(XTime t_tick, uint32_t n_periods)
+{
+
+	seqlockWriteBegin(&Ttc0PhaseLock);
+
+	if (p_Ttc0Phase->restart != 0U)
+	{
+		p_Ttc0Phase->restart = 0U;
+		p_Ttc0Phase->t_ref = t_tick;
+		p_Ttc0Phase->n_ticks = 0U;
+		p_Ttc0Phase->ideal = 0U;
+		p_Ttc0Phase->ideal_rem = 0U;
+		p_Ttc0Phase->phase = 0;
+		p_Ttc0Phase->phase_min = 0;
+		p_Ttc0Phase->phase_max = 0;
+		p_Ttc0Phase->missed = 0U;
+		seqlockWriteEnd(&Ttc0PhaseLock);
+		return;
+	}
+
+	while (n_periods > 0U)
+	{
+		p_Ttc0Phase->ideal += SCHED_TICK_COUNTS;
+		p_Ttc0Phase->ideal_rem += SCHED_TICK_COUNTS_REM;
+		if (p_Ttc0Phase->ideal_rem >= SCHED_TICK_RATE_HZ)
+		{
+			p_Ttc0Phase->ideal_rem -= SCHED_TICK_RATE_HZ;
+			p_Ttc0Phase->ideal++;
+		}
+		p_Ttc0Phase->n_ticks++;
+		n_periods--;
+	}
+
+	p_Ttc0Phase->phase = (int32_t)(t_tick - (p_Ttc0Phase->t_ref + (p_Ttc0Phase->ideal * TTC0_GT_RATIO)));
+
+	if (p_Ttc0Phase->phase < p_Ttc0Phase->phase_min)
+	{
+		p_Ttc0Phase->phase_min = p_Ttc0Phase->phase;
+	}
+	if (p_Ttc0Phase->phase > p_Ttc0Phase->phase_max)
+	{
+		p_Ttc0Phase->phase_max = p_Ttc0Phase->phase;
+	}
+
+	seqlockWriteEnd(&Ttc0PhaseLock);
+
+}
+
+
+
+/*****************************************************************************
+ * Function: ttc0TickStatsCmd()
+ *//**
+ *
+ * @brief		GET_TICK_STATS: reads the tick mode, phase error or missed
+ * 				ticks, or restarts the phase measurement.
+ *
+ * @param[in]	uint32_t field1:	Selector (TTC0_STATS_xxx).
+ * @param[in]	uint32_t field2:	Not used.
+ *
+ * @return		The selected value (WRITE_OKAY for TTC0_STATS_CLEAR), or
+ * 				CMD_ERROR for an unknown selector. Phase errors are signed,
+ * 				in Global Timer counts.
+ *
+ * @note		The statistics are written by the ISR, so they are copied under
+ * 				the seqlock, with interrupts enabled. TTC0_STATS_CLEAR only
+ * 				sets the restart flag: the ISR clears them at the next tick.
+ *
+****************************************************************************/
+
+uint32_t ttc0TickStatsCmd(uint32_t field1, uint32_t field2)
+{
+
+	uint32_t value;
+	uint32_t seq;
+	ttc0_phase_t phase;
+
+	do
+	{
+		seq = seqlockReadBegin(&Ttc0PhaseLock);
+		phase = *p_Ttc0Phase;
+	} while (seqlockReadRetry(&Ttc0PhaseLock, seq) != 0U);
+
+	switch (field1)
+	{
+	case TTC0_STATS_MODE:
+		value = TTC0_TICK_MODE;
+		break;
+
+	case TTC0_STATS_TICKS:
+		value = phase.n_ticks;
+		break;
+
+	case TTC0_STATS_PHASE:
+		value = (uint32_t)phase.phase;
+		break;
+
+	case TTC0_STATS_PHASE_MIN:
+		value = (uint32_t)phase.phase_min;
+		break;
+
+	case TTC0_STATS_PHASE_MAX:
+		value = (uint32_t)phase.phase_max;
+		break;
+
+	case TTC0_STATS_MISSED:
+		value = phase.missed;
+		break;
+
+	case TTC0_STATS_CLEAR:
+		p_Ttc0Phase->restart = 1U;
+		value = WRITE_OKAY;
+		break;
+
+	default:
+		value = CMD_ERROR;
+		break;
+	}
+
+	return value;
+
 }
 
 
@@ -40,6 +40,24 @@
 
 #include "../gpio/ps7_gpio_if.h"
 
+// Scheduler (tick counting, see scheduler.h):
+#include "../utilities/scheduler.h"
+
+// Idle mode (tick latency, see idle.h):
+#include "../utilities/idle.h"
+
+// Global Timer (tick phase error):
+#include "xtime_l.h"
+
+// Command handler (GET_TICK_STATS):
+#include "../utilities/cmd_handler.h"
+
+// Seqlock (tick phase statistics, read without masking interrupts):
+#include "../utilities/concurrency.h"
+
+// AMP (tick of the comms core, see amp.h):
+#include "../amp/amp.h"
+
 
 /*****************************************************************************/
 /************************** Constant Definitions *****************************/
@@ -55,24 +73,88 @@
 /* TTC Clock = 111MHz => Period = 9ns*/
 /* Prescaler disabled; resolution = 9ns */
 #define PRESCALER_VALUE			XTTCPS_CLK_CNTRL_PS_DISABLE
-#define TASK1_MATCH				2222U	// 20us (9ns x 2222)
-#define TASK2_MATCH				5556U	// 50us (9ns x 5556)
+#define SCHED_TICK_MATCH		5556U	// 50us (9ns x 5556); TTC0_TICK_MATCH_RESET only
+
+/* The counter is 16 bits wide */
+#define TTC0_COUNT_MASK			0xFFFFU
 
 /*
- *      _TASK1               _TASK1
- * ____| |__________________| |______________
- * 0   20us                 70us
- *                  _TASK2               _TASK2
+ *                  _TICK 0              _TICK 1
  * ________________| |__________________| |__
  * 0               50us                 100us etc
+ *
+ * Each tick, the scheduler runs the tasks that are due (see the task
+ * table in tasks.c).
  */
 
 
+/* -------- Tick generation -------*/
+/*	TTC0_TICK_MATCH_ADVANCE: the counter runs freely. Each tick, the ISR
+*	  moves MATCH0 on by one period. The period is not a whole number of
+*	  counts (111.111115MHz / 20kHz = 5555.56), so the remainder is carried
+*	  from tick to tick: periods are 5555 or 5556 counts, and the mean is
+*	  exactly 50us of the TTC0 clock. The ISR only has to run within one
+*	  period; a match that has already passed when it is set is counted as
+*	  a missed tick, and the following one is used.
+*	TTC0_TICK_INTERVAL: the counter restarts in hardware every
+*	  SCHED_TICK_INTERVAL + 1 counts (5556 = 50.004us). No software is in
+*	  the timing path, but the period is rounded to a whole count.
+*	TTC0_TICK_MATCH_RESET: the ISR resets the counter at MATCH0 (the
+*	  original scheme). The ISR entry latency is added to every period,
+*	  so the schedule drifts. Kept for comparison.
+*
+*	In every mode, the ISR reads the counter on entry, to work out the time
+*	of the tick (Global Timer at ISR entry, less the counts since the tick).
+*	The phase error is the time of the tick minus its ideal time: the
+*	reference tick + n x 50us of the TTC0 clock. Tick jitter and drift show
+*	up as a change of the phase error. */
+
+#define TTC0_TICK_MATCH_ADVANCE		0U
+#define TTC0_TICK_INTERVAL			1U
+#define TTC0_TICK_MATCH_RESET		2U
+
+#define TTC0_TICK_MODE				TTC0_TICK_MATCH_ADVANCE
+
+/* Tick rate, and period in TTC0 counts (whole counts + remainder / rate) */
+#define TTC0_CLK_FREQ_HZ			XPAR_PS7_TTC_0_TTC_CLK_FREQ_HZ
+#define SCHED_TICK_RATE_HZ			20000U		// 50us
+#define SCHED_TICK_COUNTS			(TTC0_CLK_FREQ_HZ / SCHED_TICK_RATE_HZ)
+#define SCHED_TICK_COUNTS_REM		(TTC0_CLK_FREQ_HZ % SCHED_TICK_RATE_HZ)
+#define SCHED_TICK_INTERVAL			(((TTC0_CLK_FREQ_HZ + (SCHED_TICK_RATE_HZ / 2U)) / SCHED_TICK_RATE_HZ) - 1U)
+
+/* Global Timer counts per TTC0 count (CPU/2 and CPU_1x = CPU/6) */
+#define TTC0_GT_RATIO				((COUNTS_PER_SECOND + (TTC0_CLK_FREQ_HZ / 2U)) / TTC0_CLK_FREQ_HZ)
+
+
+/* GET_TICK_STATS selectors (FIELD 1). Phase errors are signed, in Global
+ * Timer counts. */
+#define TTC0_STATS_MODE				0U		// TTC0_TICK_xxx
+#define TTC0_STATS_TICKS			1U		// Ticks since the reference tick
+#define TTC0_STATS_PHASE			2U		// Phase error of the last tick
+#define TTC0_STATS_PHASE_MIN		3U
+#define TTC0_STATS_PHASE_MAX		4U
+#define TTC0_STATS_MISSED			5U		// Match passed before it was set
+#define TTC0_STATS_CLEAR			6U		// Next tick is the new reference
+
+
 
 /*****************************************************************************/
 /******************************* Typedefs ************************************/
 /*****************************************************************************/
 
+/* Tick phase error, measured against the Global Timer */
+typedef struct {
+	uint32_t restart;			// Take the next tick as the reference
+	uint32_t n_ticks;			// Ticks since the reference
+	XTime t_ref;				// Time of the reference tick (Global Timer)
+	uint64_t ideal;				// Ideal time of the last tick, TTC0 counts after t_ref
+	uint32_t ideal_rem;			// Remainder of ideal, in 1/SCHED_TICK_RATE_HZ counts
+	int32_t phase;				// Phase error of the last tick
+	int32_t phase_min;
+	int32_t phase_max;
+	uint32_t missed;			// Ticks missed (TTC0_TICK_MATCH_ADVANCE)
+} ttc0_phase_t;
+
 
 
 /*****************************************************************************/
@@ -101,10 +183,7 @@ void xTtc0IntrHandler(void *CallBackRef);
 /* Interface functions */
 void startTtc0(void);
 void resetTtc0(void);
-
-/* Task functions */
-uint32_t getTask1TriggerState(void);
-uint32_t getTask2TriggerState(void);
+int ttc0RegisterCommands(void);
 
 
 #endif /* SRC_TIMERS_TTC0_IF_H_ */
@@ -30,8 +30,13 @@
 
 /***************************** Include Files ********************************/
 
+#include <string.h>
+
 #include "ps7_uart1_if.h"
 
+/* Shared variable test (see tasks.h) */
+#include "../tasks.h"
+
 
 /************************** Variable Definitions ****************************/
 
@@ -42,10 +47,65 @@ static XUartPs		*p_XUart1PsInst = &XUart1PsInst;
 
 
 /* === Buffers === */
-/* Uart Buffer for receiving data from host */
-static uint8_t RxBuffer [UART_RX_BUFFER_SIZE] = {0};
-/* Uart Buffer for sending data to host */
-static uint8_t TxBuffer [UART_TX_BUFFER_SIZE] = {0};
+/* Receive ring: the ISR (producer) copies bytes from the RX FIFO; the main
+ * loop (consumer) passes them to the frame parser (frame_codec.c) and
+ * executes each complete frame (see uart1ServiceCommands()). One writer per
+ * index, so neither side disables interrupts (see spsc_ring.h). */
+SPSC_RING_DEFINE(uart_rx_ring_t, uartRx, uint8_t, UART_RX_RING_SIZE)
+static uart_rx_ring_t RxRing;
+/* Transmit ring: the main loop writes framed responses; the ISR moves them
+ * to the TX FIFO. */
+static uint8_t TxRing [UART_TX_RING_SIZE];
+/* Response being built by the main loop */
+static uint8_t TxFrame [UART_TX_MAX_FRAME_SIZE] = {0};
+
+
+/* === Ring state === */
+/* Transmit ring: free-running byte counters; the ring index is
+ * (counter & (SIZE - 1)). Each counter has the writer shown below. */
+static volatile uint32_t tx_wr = 0U;		// Bytes queued (main loop)
+static volatile uint32_t tx_rd = 0U;		// Bytes moved to the TX FIFO (ISR, or
+											// main loop with interrupts disabled)
+
+/* Line idle seen by the ISR (set by ISR, cleared by main loop) */
+static volatile uint32_t rx_idle = 0U;
+
+/* Receive errors: the ring positions where the frame parser is reset, once
+ * the bytes received before each error have been parsed. The ISR pushes a
+ * position per error, the main loop releases it, so an error is not lost
+ * while the parser is still behind an earlier one. */
+SPSC_RING_DEFINE(uart_resync_ring_t, uartResync, uint32_t, UART_RX_RESYNC_SLOTS)
+static uart_resync_ring_t ResyncRing;
+
+/* Receive error counters */
+static uart_link_stats_t	LinkStats;
+static uart_link_stats_t	*p_LinkStats = &LinkStats;
+
+/* The frame parser holds a complete frame (main loop) */
+static uint32_t rx_frame_ready = 0U;
+
+
+/* === Baud rate negotiation === */
+/* Used from the main loop only (commands and uart1BaudTick()). */
+static uart_baud_t	UartBaud;
+static uart_baud_t	*p_UartBaud = &UartBaud;
+
+
+
+/************************** Function Prototypes *****************************/
+
+/* Functions internal to this file */
+static uint32_t parseRxRing(void);
+static void publishResponse(uint32_t n_bytes_frame);
+static void fillTxFifo(void);
+static int switchBaudRate(uint32_t rate);
+static void handleRxError(void);
+static void rxResyncAt(uint32_t pos);
+
+/* Command handlers */
+static uint32_t setBaudCmd(uint32_t field1, uint32_t field2);
+static uint32_t baudConfirmCmd(uint32_t field1, uint32_t field2);
+static uint32_t linkStatsCmd(uint32_t field1, uint32_t field2);
 
 
 
@@ -135,13 +195,28 @@ int xUart1PsInit(uint32_t *p_inst) {
 	/* Configuration steps are:
 	 * (1) Set the interrupt handler.
 	 * (2) Enable desired interrupts.
-	 * (3) Set FIFO threshold.
-	 * (4) Configure the UART in Normal Mode.*/
+	 * (3) Set FIFO threshold and RX timeout.
+	 * (4) Set the baud rate.
+	 * (5) Configure the UART in Normal Mode.
+	 * (6) Reset the receive ring and the frame parser. */
 
 	XUartPs_SetHandler(p_XUart1PsInst, (XUartPs_Handler)UartIntrHandler, p_XUart1PsInst);
-	XUartPs_SetInterruptMask(p_XUart1PsInst, XUARTPS_IXR_RXOVR);
-	XUartPs_SetFifoThreshold(p_XUart1PsInst, UART_RX_BUFFER_SIZE);
+	XUartPs_SetInterruptMask(p_XUart1PsInst, XUARTPS_IXR_RXOVR | XUARTPS_IXR_TOUT | UART_RX_ERROR_MASK);
+	XUartPs_SetFifoThreshold(p_XUart1PsInst, UART_RX_FIFO_TRIGGER);
+	XUartPs_SetRecvTimeout(p_XUart1PsInst, UART_RX_TIMEOUT);
+
+	status = XUartPs_SetBaudRate(p_XUart1PsInst, UART_BAUD_DEFAULT);
+	if (status != XST_SUCCESS)
+	{
+		return status;
+	}
+	p_UartBaud->state = UART_BAUD_IDLE;
+	p_UartBaud->rate = UART_BAUD_DEFAULT;
+
 	XUartPs_SetOperMode(p_XUart1PsInst, XUARTPS_OPER_MODE_NORMAL);
+	uartRxInit(&RxRing);
+	uartResyncInit(&ResyncRing);
+	frameParserReset();
 
 
 	/* === END CONFIGURATION SEQUENCE ===  */
@@ -172,34 +247,38 @@ int xUart1PsInit(uint32_t *p_inst) {
  * 				 detected. The Rx and Tx events occur in pairs as follows:
  *
  * 				 1. RECV EVENT:
- * 				 a. A RECV EVENT occurs when the 10-byte command frame is
- * 				 received from the host PC.
+ * 				 a. A RECV EVENT occurs when the RX FIFO reaches its trigger
+ * 				 level, or when the line goes idle with bytes in the FIFO.
  * 				 b. The event and event data are stored to memory for test purposes.
- * 				 c. XUartPs_Recv() is called to transfer the received bytes from
- * 				 the UART HW buffer to the software RxBuffer.
- * 				 d. The function handleCommand() is called to execute the command.
- * 				 e. XUartPs_Send() is called to send the response back to the host PC.
- * 				 f. For debug purposes, an assertion is triggered if the number of
- * 				 bytes sent back is not equal to 4.
- * 				 g. Otherwise the ISR exits.
+ * 				 c. The RX FIFO is drained into the receive ring. If the line is
+ * 				 idle, this is flagged for the frame parser.
+ * 				 d. The ISR exits. The bytes are parsed, the commands executed and
+ * 				 the responses queued by uart1ServiceCommands() from the main loop.
  *
  * 				 2. SEND EVENT:
- * 				 a. When the response is sent back to the host PC, the ISR is called
- * 				 again.
+ * 				 a. When the TX FIFO is empty (TXEMPTY enabled by fillTxFifo()),
+ * 				 the ISR is called again.
  * 				 b. The event and event data are stored to memory for test purposes.
- * 				 c. The ISR exits.
+ * 				 c. The TX FIFO is refilled from the transmit ring.
+ * 				 d. The ISR exits.
+ *
+ * 				 3. RECEIVE ERROR (overrun, framing, parity):
+ * 				 a. The error is counted by class (see GET_LINK_STATS).
+ * 				 b. The RX FIFO is flushed, and the frame parser is reset once the
+ * 				 bytes received before the error have been parsed. The frame being
+ * 				 received is lost; the host times out on its tag and sends it again.
  *
- * 				 The ISR can also be called for an unexpected event such as an error
- * 				 or buffer overflow. However, in this simple program the UART has not
- * 				 been specifically configured to allow such events to occur, so if
- * 				 such an event occurs, the code asserts.
+ * 				 Any other event (e.g. modem status) is counted and ignored.
  *
  *
  * @note		Modifications for sw_proj10:
  * 				1. Nested interrupts supported to allow higher-priority task
  * 				to interrupt this handler.
- * 				2. Shared variables in system_config.c are modified for shared
- * 				variable test.
+ * 				2. Commands are no longer executed here, so the handler does not
+ * 				modify the task shared variables (see tasks.c).
+ * 				3. The handler only moves bytes between the FIFOs and the rings,
+ * 				so its run time does not depend on the frame size. XUartPs_Send()
+ * 				is not used.
  *
 ****************************************************************************/
 
@@ -219,9 +298,10 @@ void UartIntrHandler(void *CallBackRef, uint32_t event, uint32_t event_data)
 
 	// --------------------------------------------------------------------------------- //
 	// event == XUARTPS_EVENT_RECV_DATA
-	// 10 bytes should now have been received from the host.
+	// The RX FIFO has reached its trigger level, or the RX timeout has
+	// expired with bytes in the FIFO.
 	// --------------------------------------------------------------------------------- //
-	if (event == XUARTPS_EVENT_RECV_DATA)
+	if ( (event == XUARTPS_EVENT_RECV_DATA) || (event == XUARTPS_EVENT_RECV_TOUT) )
 	{
 
 		psGpOutSet(PS_GP_OUT6);	/// TEST SIGNAL: SET UART RX INTR
@@ -234,27 +314,53 @@ void UartIntrHandler(void *CallBackRef, uint32_t event, uint32_t event_data)
 #endif
 
 		/* === RX FROM HOST === */
-		/* Get the data received from the host */
-		XUartPs_Recv(p_XUart1PsInst, RxBuffer, UART_RX_BUFFER_SIZE);
-
-		/* Call function to handle the data */
-		handleCommand(RxBuffer, TxBuffer);
-
-		/* === TX TO HOST === */
-		/* Send the response data to the host.
-		 * Note that XUartPs_Send() will enable some TX interrupts. */
-		uint32_t n_bytes_sent = 0;
-		n_bytes_sent = XUartPs_Send(p_XUart1PsInst, TxBuffer, UART_TX_BUFFER_SIZE);
-
-		/* Assert if number of sent bytes is incorrect. */
-		Xil_AssertVoid(n_bytes_sent == UART_TX_BUFFER_SIZE);
-
-
-
+		/* Copy every byte in the RX FIFO to the receive ring */
+		uint32_t base_addr = p_XUart1PsInst->Config.BaseAddress;
+		uint32_t n_free = uartRxFree(&RxRing);
+		uint32_t n_rx = 0U;
+		uint32_t overflow = 0U;
+
+		/* The driver clears the interrupt status after this handler returns,
+		 * so the RX timeout (line idle) status is still visible here. */
+		uint32_t line_idle = XUartPs_ReadReg(base_addr, XUARTPS_ISR_OFFSET) & XUARTPS_IXR_TOUT;
+
+		while (XUartPs_IsReceiveData(base_addr))
+		{
+			uint8_t rx_byte = (uint8_t)XUartPs_ReadReg(base_addr, XUARTPS_FIFO_OFFSET);
+
+			if (n_rx != n_free)
+			{
+				*uartRxSlot(&RxRing, n_rx) = rx_byte;
+				n_rx++;
+			}
+			else
+			{
+				/* Ring full: keep draining the FIFO, or RXOVR stays active */
+				overflow = 1U;
+			}
+		}
+
+		/* Publish the bytes to the main loop */
+		uartRxPublish(&RxRing, n_rx);
+
+		/* Bytes lost: resynchronise the parser where they were lost */
+		if (overflow != 0U)
+		{
+			frameCountDropped();
+			rxResyncAt(uartRxHead(&RxRing));
+		}
+
+		if (line_idle != 0U)
+		{
+			rx_idle = 1U;
+		}
+
+#if (TASK1_SHARED_VAR_TEST || TASK2_SHARED_VAR_TEST) && !AMP_MODE
 		/* Added in sw_proj10 to 'trample on' the shared variables in
-		 * the system_config tasks. Used for the shared variable test. */
-	    setTask1SharedVariable(0x12345678);
-	    setTask2SharedVariable(0x12345678);
+		 * the tasks. Used for the shared variable test. */
+		setTask1SharedVariable(0x12345678);
+		setTask2SharedVariable(0x12345678);
+#endif
 
 
 
@@ -277,6 +383,9 @@ void UartIntrHandler(void *CallBackRef, uint32_t event, uint32_t event_data)
 		Xil_Out32( 0x0200000C, event_data);
 #endif
 
+		/* Refill the TX FIFO from the transmit ring */
+		fillTxFifo();
+
 		psGpOutClear(PS_GP_OUT7);	/// TEST SIGNAL: CLEAR UART TX INTR
 
 	}
@@ -284,15 +393,23 @@ void UartIntrHandler(void *CallBackRef, uint32_t event, uint32_t event_data)
 
 
 	// --------------------------------------------------------------------------------- //
-	// Assert for any other event.
+	// Receive errors: count, flush and resynchronise.
 	// --------------------------------------------------------------------------------- //
-	else if ( (event == XUARTPS_EVENT_RECV_TOUT)
-			| (event == XUARTPS_EVENT_RECV_ERROR)
-			| (event == XUARTPS_EVENT_MODEM)
-			| (event == XUARTPS_EVENT_PARE_FRAME_BRKE)
-			| (event == XUARTPS_EVENT_RECV_ORERR) )
+	else if ( (event == XUARTPS_EVENT_RECV_ERROR)
+			|| (event == XUARTPS_EVENT_PARE_FRAME_BRKE)
+			|| (event == XUARTPS_EVENT_RECV_ORERR) )
 	{
-		Xil_AssertVoid(0U);
+		handleRxError();
+	}
+
+
+
+	// --------------------------------------------------------------------------------- //
+	// Count any other event.
+	// --------------------------------------------------------------------------------- //
+	else
+	{
+		p_LinkStats->other++;
 	}
 
 
@@ -305,6 +422,665 @@ void UartIntrHandler(void *CallBackRef, uint32_t event, uint32_t event_data)
 }
 
 
+/*****************************************************************************
+ * Function: uart1ServiceCommands()
+ *//**
+ *
+ * @brief		Parses the receive ring up to the next complete frame, executes
+ * 				its command and queues the response to the host.
+ *
+ * @details		The frame's LEN must match the size of the command it carries
+ * 				(10 bytes, plus any BATCH/WRITE_BLOCK payload). If it does not,
+ * 				the command is not executed, a framing error is counted and
+ * 				CMD_ERROR is returned to the host.
+ *
+ * 				If the transmit ring cannot hold a response of the largest
+ * 				size, the command is left in the receive ring until enough
+ * 				has been sent.
+ *
+ * 				A command may defer its response (WAIT_FOR); it is then queued
+ * 				later through uart1QueueResponse().
+ *
+ * @return		1 if a command was executed, otherwise 0.
+ *
+ * @note		Called from the main loop while it waits for the next task
+ * 				trigger, so that command execution does not delay the tasks by
+ * 				more than one command. Must not be called with interrupts
+ * 				disabled (they are re-enabled on return).
+ *
+****************************************************************************/
+
+uint32_t uart1ServiceCommands(void)
+{
+
+	uint8_t *p_rx_frame;
+	uint8_t tag;
+	uint32_t n_bytes_resp = 0;
+
+	/* No room for the response yet */
+	if ((UART_TX_RING_SIZE - (tx_wr - tx_rd)) < UART_TX_MAX_FRAME_SIZE)
+	{
+		return 0U;
+	}
+
+	/* Nothing to do */
+	if (rx_frame_ready == 0U)
+	{
+		rx_frame_ready = parseRxRing();
+		if (rx_frame_ready == 0U)
+		{
+			return 0U;
+		}
+	}
+
+	p_rx_frame = frameGetPayload();
+	tag = frameGetTag();
+
+	/* Call function to handle the data. The tag identifies the request if
+	 * the response is deferred (e.g. WAIT_FOR). */
+	if (frameGetPayloadSize() == (CMD_FRAME_NBYTES + getCommandPayloadSize(p_rx_frame)))
+	{
+		n_bytes_resp = handleCommand(p_rx_frame, &TxFrame[FRAME_HEADER_NBYTES], tag);
+	}
+	else
+	{
+		frameCountFramingError();
+		setResponseBytes(&TxFrame[FRAME_HEADER_NBYTES], CMD_ERROR);
+		n_bytes_resp = RESPONSE_NBYTES;
+	}
+
+	/* Release the frame. The parser may already hold the next one. */
+	rx_frame_ready = frameConsume();
+
+	/* === TX TO HOST === */
+	/* No response now if the command deferred it */
+	if (n_bytes_resp != 0U)
+	{
+		publishResponse(frameEncode(TxFrame, n_bytes_resp, tag));
+	}
+
+	return 1U;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: uart1WorkPending()
+ *//**
+ *
+ * @brief		Checks whether uart1ServiceCommands() has work to do.
+ *
+ * @details		There is work if bytes are waiting in the receive ring, the
+ * 				ISR has seen the line go idle or a receive error, or the parser
+ * 				holds a frame and the transmit ring has room for its response.
+ * 				Otherwise, only an interrupt (RX or TX) can create work, so
+ * 				the main loop can sleep (see idleWait()).
+ *
+ * @return		1 if there is work to do, otherwise 0.
+ *
+ * @note		Called from the main loop with interrupts disabled.
+ *
+****************************************************************************/
+
+uint32_t uart1WorkPending(void)
+{
+
+	if ( (uartRxCount(&RxRing) != 0U) || (rx_idle != 0U) || (uartResyncCount(&ResyncRing) != 0U) )
+	{
+		return 1U;
+	}
+
+	if ( (rx_frame_ready != 0U)
+			&& ((UART_TX_RING_SIZE - (tx_wr - tx_rd)) >= UART_TX_MAX_FRAME_SIZE) )
+	{
+		return 1U;
+	}
+
+	return 0U;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: uart1QueueResponse()
+ *//**
+ *
+ * @brief		Queues a deferred response to the host (see setCommandResponder()).
+ *
+ * @param[in]	request_id: The request's tag.
+ * @param[in]	*response: Response bytes.
+ * @param[in]	n_bytes: Number of response bytes (max CMD_MAX_RESPONSE_NBYTES).
+ *
+ * @return		XST_SUCCESS, or XST_FAILURE if the transmit ring is full.
+ *
+ * @note		Called from the main loop only.
+ *
+****************************************************************************/
+
+int uart1QueueResponse(uint32_t request_id, uint8_t *response, uint32_t n_bytes)
+{
+
+	if ( (n_bytes > CMD_MAX_RESPONSE_NBYTES)
+			|| ((UART_TX_RING_SIZE - (tx_wr - tx_rd)) < (FRAME_HEADER_NBYTES + n_bytes + FRAME_CRC_NBYTES)) )
+	{
+		return XST_FAILURE;
+	}
+
+	memcpy(&TxFrame[FRAME_HEADER_NBYTES], response, n_bytes);
+
+	publishResponse(frameEncode(TxFrame, n_bytes, (uint8_t)request_id));
+
+	return XST_SUCCESS;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: parseRxRing()
+ *//**
+ *
+ * @brief		Passes bytes from the receive ring to the frame parser until a
+ * 				complete frame is found or the ring is empty.
+ *
+ * @details		When the ring is empty and the ISR has seen the line go idle,
+ * 				frameRxIdle() lets the parser recover from a false SOF.
+ *
+ * 				After a receive error, the parser is resynchronised when it
+ * 				reaches the ring position of the error (see handleRxError()).
+ *
+ * @return		1 if the parser holds a complete frame, otherwise 0.
+ *
+ * @note		Called from the main loop only.
+ *
+****************************************************************************/
+
+uint32_t parseRxRing(void)
+{
+
+	uint32_t rd = uartRxTail(&RxRing);
+	uint32_t n_avail = uartRxCount(&RxRing);
+	uint32_t n_parsed = 0U;
+	uint32_t frame_ready = 0U;
+
+	while (frame_ready == 0U)
+	{
+		/* Receive error at this position: no more bytes of the frame being
+		 * received will come. Recover any complete frames the parser holds
+		 * (one per call), then drop the rest. */
+		if ( (uartResyncCount(&ResyncRing) != 0U)
+				&& ((rd + n_parsed) == *uartResyncItem(&ResyncRing, 0U)) )
+		{
+			frame_ready = frameRxIdle();
+			if (frame_ready == 0U)
+			{
+				uartResyncRelease(&ResyncRing, 1U);
+				frameParserReset();
+				p_LinkStats->resyncs++;
+			}
+			continue;
+		}
+
+		if (n_parsed == n_avail)
+		{
+			break;
+		}
+
+		frame_ready = frameRxByte(*uartRxItem(&RxRing, n_parsed));
+		n_parsed++;
+	}
+
+	/* Release the parsed bytes to the ISR */
+	uartRxRelease(&RxRing, n_parsed);
+
+	/* Line idle, and every byte received before it has been parsed. The
+	 * flag is cleared first, so an idle seen by the ISR after the ring
+	 * check below is not lost. */
+	if ((frame_ready == 0U) && (rx_idle == 1U))
+	{
+		rx_idle = 0U;
+		if (uartRxCount(&RxRing) == 0U)
+		{
+			frame_ready = frameRxIdle();
+		}
+		else
+		{
+			rx_idle = 1U;
+		}
+	}
+
+	return frame_ready;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: publishResponse()
+ *//**
+ *
+ * @brief		Copies the response built in TxFrame to the transmit ring, and
+ * 				starts sending it if the transmitter is idle.
+ *
+ * @param[in]	n_bytes_frame: Size of the framed response.
+ *
+ * @return		None.
+ *
+ * @note		The caller has checked that the ring has room. Interrupts are
+ * 				disabled while the TX FIFO is filled, so that the SEND EVENT
+ * 				cannot fill it at the same time. Called from the main loop only.
+ *
+****************************************************************************/
+
+void publishResponse(uint32_t n_bytes_frame)
+{
+
+	uint32_t idx = tx_wr & (UART_TX_RING_SIZE - 1U);
+	uint32_t n_first = UART_TX_RING_SIZE - idx;
+
+	/* Copy, wrapping around the end of the ring */
+	if (n_bytes_frame <= n_first)
+	{
+		memcpy(&TxRing[idx], TxFrame, n_bytes_frame);
+	}
+	else
+	{
+		memcpy(&TxRing[idx], TxFrame, n_first);
+		memcpy(TxRing, &TxFrame[n_first], n_bytes_frame - n_first);
+	}
+
+	/* Publish the bytes to the ISR */
+	tx_wr += n_bytes_frame;
+
+	Xil_ExceptionDisable();
+	fillTxFifo();
+	Xil_ExceptionEnable();
+
+}
+
+
+
+/*****************************************************************************
+ * Function: fillTxFifo()
+ *//**
+ *
+ * @brief		Moves bytes from the transmit ring to the TX FIFO until the
+ * 				FIFO is full or the ring is empty.
+ *
+ * @details		If bytes are left in the ring, the TXEMPTY interrupt is enabled
+ * 				so that the SEND EVENT calls this function again. (The driver
+ * 				disables TXEMPTY before it reports the SEND EVENT.)
+ *
+ * @return		None.
+ *
+ * @note		Called from the SEND EVENT, or with interrupts disabled.
+ *
+****************************************************************************/
+
+void fillTxFifo(void)
+{
+
+	uint32_t base_addr = p_XUart1PsInst->Config.BaseAddress;
+	uint32_t rd = tx_rd;
+	uint32_t wr = tx_wr;
+
+	while ((rd != wr) && (!XUartPs_IsTransmitFull(base_addr)))
+	{
+		XUartPs_WriteReg(base_addr, XUARTPS_FIFO_OFFSET, TxRing[rd & (UART_TX_RING_SIZE - 1U)]);
+		rd++;
+	}
+
+	tx_rd = rd;
+
+	if (rd != wr)
+	{
+		/* Clear a stale TXEMPTY status before enabling the interrupt */
+		XUartPs_WriteReg(base_addr, XUARTPS_ISR_OFFSET, XUARTPS_IXR_TXEMPTY);
+		XUartPs_WriteReg(base_addr, XUARTPS_IER_OFFSET, XUARTPS_IXR_TXEMPTY);
+	}
+
+}
+
+
+
+/*****************************************************************************
+ * Function: uart1RegisterCommands()
+ *//**
+ *
+ * @brief		Registers SET_BAUD, BAUD_CONFIRM and GET_LINK_STATS with the
+ * 				command handler.
+ *
+ * @return		XST_SUCCESS, or XST_FAILURE if registration failed.
+ *
+ * @note		cmdHandlerInit() must be called first.
+ *
+****************************************************************************/
+
+int uart1RegisterCommands(void)
+{
+
+	int status = XST_SUCCESS;
+
+	status |= registerCommand(SET_BAUD, setBaudCmd);
+	status |= registerCommand(BAUD_CONFIRM, baudConfirmCmd);
+	status |= registerCommand(GET_LINK_STATS, linkStatsCmd);
+
+	return (status == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: uart1BaudTick()
+ *//**
+ *
+ * @brief		Runs the baud rate negotiation (see ps7_uart1_if.h).
+ *
+ * @details		PENDING: once the SET_BAUD response has left the transmitter,
+ * 				switches to the new rate and starts the VERIFY timeout.
+ * 				VERIFY: counts down the timeout, and goes back to the old rate
+ * 				if it expires before BAUD_CONFIRM is received.
+ *
+ * @return		None.
+ *
+ * @note		Called once per TTC0 cycle, from the main loop.
+ *
+****************************************************************************/
+
+void uart1BaudTick(void)
+{
+
+	uint32_t base_addr = p_XUart1PsInst->Config.BaseAddress;
+
+	if (p_UartBaud->state == UART_BAUD_PENDING)
+	{
+		/* Wait until every queued response has been sent, and the last
+		 * byte has left the shift register. */
+		if ( (tx_wr != tx_rd)
+				|| ((XUartPs_ReadReg(base_addr, XUARTPS_SR_OFFSET) & XUARTPS_SR_TXEMPTY) == 0U)
+				|| ((XUartPs_ReadReg(base_addr, XUARTPS_SR_OFFSET) & XUARTPS_SR_TACTIVE) != 0U) )
+		{
+			return;
+		}
+
+		if (switchBaudRate(p_UartBaud->new_rate) == XST_SUCCESS)
+		{
+			p_UartBaud->state = UART_BAUD_VERIFY;
+			p_UartBaud->ticks_left = p_UartBaud->timeout;
+		}
+		else
+		{
+			/* Rate not possible: stay at the old rate. The host's
+			 * BAUD_CONFIRM times out, and it goes back too. */
+			p_UartBaud->state = UART_BAUD_IDLE;
+		}
+	}
+	else if (p_UartBaud->state == UART_BAUD_VERIFY)
+	{
+		p_UartBaud->ticks_left--;
+		if (p_UartBaud->ticks_left == 0U)
+		{
+			(void)switchBaudRate(p_UartBaud->old_rate);
+			p_UartBaud->state = UART_BAUD_IDLE;
+		}
+	}
+
+}
+
+
+
+/*****************************************************************************
+ * Function: setBaudCmd()
+ *//**
+ *
+ * @brief		SET_BAUD: starts a change of baud rate.
+ * 				Field 1 = new rate; Field 2 = VERIFY timeout in TTC0 cycles
+ * 				(0 = UART_BAUD_VERIFY_TIMEOUT).
+ *
+ * @return		WRITE_OKAY (sent at the old rate), or CMD_ERROR if the rate is
+ * 				out of range or a change is already in progress.
+ *
+ * @note		The rate is changed later, by uart1BaudTick().
+ *
+****************************************************************************/
+
+uint32_t setBaudCmd(uint32_t field1, uint32_t field2)
+{
+
+	if ( (p_UartBaud->state != UART_BAUD_IDLE)
+			|| (field1 < XUARTPS_MIN_RATE)
+			|| (field1 > XUARTPS_MAX_RATE) )
+	{
+		return CMD_ERROR;
+	}
+
+	p_UartBaud->old_rate = p_UartBaud->rate;
+	p_UartBaud->new_rate = field1;
+	p_UartBaud->timeout = (field2 == 0U) ? UART_BAUD_VERIFY_TIMEOUT : field2;
+	p_UartBaud->state = UART_BAUD_PENDING;
+
+	return WRITE_OKAY;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: baudConfirmCmd()
+ *//**
+ *
+ * @brief		BAUD_CONFIRM: keeps the new baud rate after SET_BAUD. Can also
+ * 				be used at any time to read the current rate.
+ *
+ * @return		The current baud rate.
+ *
+****************************************************************************/
+
+uint32_t baudConfirmCmd(uint32_t field1, uint32_t field2)
+{
+
+	if (p_UartBaud->state == UART_BAUD_VERIFY)
+	{
+		p_UartBaud->state = UART_BAUD_IDLE;
+	}
+
+	return p_UartBaud->rate;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: switchBaudRate()
+ *//**
+ *
+ * @brief		Changes the UART baud rate, discarding any bytes received
+ * 				during the change and resetting the frame parser.
+ *
+ * @param[in]	rate: New baud rate.
+ *
+ * @return		XST_SUCCESS, or the driver error if the rate cannot be
+ * 				generated within 3% (the old rate is kept).
+ *
+ * @note		Interrupts are disabled so that the ISR does not run while the
+ * 				parser is reset.
+ *
+****************************************************************************/
+
+int switchBaudRate(uint32_t rate)
+{
+
+	int status;
+	uint32_t base_addr = p_XUart1PsInst->Config.BaseAddress;
+
+	Xil_ExceptionDisable();
+
+	status = XUartPs_SetBaudRate(p_XUart1PsInst, rate);
+	if (status == XST_SUCCESS)
+	{
+		LOG2(LOG_UART_BAUD, p_UartBaud->rate, rate);
+		p_UartBaud->rate = rate;
+
+		while (XUartPs_IsReceiveData(base_addr))
+		{
+			(void)XUartPs_ReadReg(base_addr, XUARTPS_FIFO_OFFSET);
+		}
+		uartRxRelease(&RxRing, uartRxCount(&RxRing));
+		rx_idle = 0U;
+		uartResyncRelease(&ResyncRing, uartResyncCount(&ResyncRing));
+		rx_frame_ready = 0U;
+		frameParserReset();
+	}
+
+	Xil_ExceptionEnable();
+
+	return status;
+
+}
+
+
+
+/*****************************************************************************
+ * Function: linkStatsCmd()
+ *//**
+ *
+ * @brief		GET_LINK_STATS: reads or clears the receive error counters.
+ * 				Field 1 = selector (UART_LINK_STATS_xxx).
+ *
+ * @return		The selected counter (WRITE_OKAY for UART_LINK_STATS_CLEAR), or
+ * 				CMD_ERROR for an unknown selector.
+ *
+****************************************************************************/
+
+uint32_t linkStatsCmd(uint32_t field1, uint32_t field2)
+{
+
+	switch (field1)
+	{
+	case UART_LINK_STATS_OVERRUN:
+		return p_LinkStats->overrun;
+
+	case UART_LINK_STATS_FRAMING:
+		return p_LinkStats->framing;
+
+	case UART_LINK_STATS_PARITY:
+		return p_LinkStats->parity;
+
+	case UART_LINK_STATS_OTHER:
+		return p_LinkStats->other;
+
+	case UART_LINK_STATS_FLUSHED:
+		return p_LinkStats->flushed;
+
+	case UART_LINK_STATS_RESYNCS:
+		return p_LinkStats->resyncs;
+
+	case UART_LINK_STATS_CLEAR:
+		p_LinkStats->overrun = 0U;
+		p_LinkStats->framing = 0U;
+		p_LinkStats->parity = 0U;
+		p_LinkStats->other = 0U;
+		p_LinkStats->flushed = 0U;
+		p_LinkStats->resyncs = 0U;
+		return WRITE_OKAY;
+
+	default:
+		return CMD_ERROR;
+	}
+
+}
+
+
+
+/*****************************************************************************
+ * Function: handleRxError()
+ *//**
+ *
+ * @brief		Counts a receive error by class, flushes the RX FIFO and asks
+ * 				the main loop to reset the frame parser.
+ *
+ * @details		The bytes already in the receive ring were received before the
+ * 				error, so they are still parsed. When the parser reaches the
+ * 				current ring position (see parseRxRing()), any complete frames
+ * 				it holds are recovered and the frame the error was part of is
+ * 				dropped.
+ *
+ * @return		None.
+ *
+ * @note		Called from UartIntrHandler() only. The driver clears the
+ * 				interrupt status after the handler returns, so the error bits
+ * 				are still visible here.
+ *
+****************************************************************************/
+
+void handleRxError(void)
+{
+
+	uint32_t base_addr = p_XUart1PsInst->Config.BaseAddress;
+	uint32_t isr_status = XUartPs_ReadReg(base_addr, XUARTPS_ISR_OFFSET);
+	uint32_t n_flushed = 0U;
+
+	if ((isr_status & XUARTPS_IXR_OVER) != 0U)
+	{
+		p_LinkStats->overrun++;
+	}
+	if ((isr_status & (XUARTPS_IXR_FRAMING | XUARTPS_IXR_RBRK)) != 0U)
+	{
+		p_LinkStats->framing++;
+	}
+	if ((isr_status & XUARTPS_IXR_PARITY) != 0U)
+	{
+		p_LinkStats->parity++;
+	}
+
+	/* Flush the RX FIFO */
+	while (XUartPs_IsReceiveData(base_addr))
+	{
+		(void)XUartPs_ReadReg(base_addr, XUARTPS_FIFO_OFFSET);
+		n_flushed++;
+	}
+	p_LinkStats->flushed += n_flushed;
+
+	LOG2(LOG_UART_RX_ERROR, isr_status, n_flushed);
+
+	/* Resynchronise the parser at the current ring position */
+	rxResyncAt(uartRxHead(&RxRing));
+
+}
+
+
+
+/*****************************************************************************
+ * Function: rxResyncAt()
+ *//**
+ *
+ * @brief		Asks the main loop to reset the frame parser when it reaches
+ * 				a position in the receive ring.
+ *
+ * @details		If UART_RX_RESYNC_SLOTS errors are already waiting, the
+ * 				position is not kept: a frame joined across the error is then
+ * 				rejected by its CRC.
+ *
+ * @param		pos: ring position (uartRxHead()) of the error.
+ *
+ * @return		None.
+ *
+ * @note		Called from the ISR only.
+ *
+****************************************************************************/
+
+void rxResyncAt(uint32_t pos)
+{
+
+	(void)uartResyncPush(&ResyncRing, &pos);
+
+}
+
+
+
 /****** End functions *****/
 
 /****** End of File **********************************************************/
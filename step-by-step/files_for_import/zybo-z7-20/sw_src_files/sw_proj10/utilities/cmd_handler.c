@@ -34,6 +34,8 @@
 /*****************************************************************************/
 
 #include "cmd_handler.h"
+#include "wait_for.h"
+#include "sequencer.h"
 
 
 
@@ -45,6 +47,15 @@
 static cmd_frame		CmdFrameInst;
 static cmd_frame 		*p_cmd_frame = &CmdFrameInst;
 
+/* Command registry, indexed by command code */
+static cmd_entry_t		CmdTable[CMD_TABLE_SIZE];
+
+/* Comms block function used to send deferred responses */
+static cmd_responder_t	p_responder = NULL;
+
+/* Executes the commands not registered on this core (AMP) */
+static cmd_remote_t		p_remote = NULL;
+
 
 
 
@@ -55,7 +66,18 @@ static cmd_frame 		*p_cmd_frame = &CmdFrameInst;
 /* Functions internal to the command handler */
 static void decodeRxData(uint8_t *rx_buffer);
 static void executeCommand(uint8_t *tx_buffer);
-static void setResponseBytes(uint8_t *tx_buffer, uint32_t tx_data);
+static uint32_t writeWordCmd(uint32_t field1, uint32_t field2);
+static uint32_t readWordCmd(uint32_t field1, uint32_t field2);
+static uint32_t getCmdStatsCmd(uint32_t field1, uint32_t field2);
+static uint32_t setBitsCmd(uint32_t field1, uint32_t field2);
+static uint32_t clearBitsCmd(uint32_t field1, uint32_t field2);
+static uint32_t toggleBitsCmd(uint32_t field1, uint32_t field2);
+static uint32_t executeReadBlock(uint8_t *tx_buffer);
+static uint32_t executeWriteBlock(uint8_t *payload, uint8_t *tx_buffer);
+static uint32_t executeSeqLoad(uint8_t *payload, uint8_t *tx_buffer);
+static uint32_t checkPayloadChecksum(uint8_t *payload, uint32_t n_words);
+static uint32_t getWordFromBytes(uint8_t *rx_buffer);
+static uint32_t isFrameCommand(uint32_t cmd);
 
 
 
@@ -65,6 +87,171 @@ static void setResponseBytes(uint8_t *tx_buffer, uint32_t tx_data);
 
 
 
+/******************************************************************************
+*
+* Function:		cmdHandlerInit()
+*
+* Description:	Clears the command registry.
+*
+* Returns:		XST_SUCCESS.
+*
+* Notes:		Must be called before any module registers its commands,
+* 				including the command handler itself (cmdRegisterCommands()).
+*
+****************************************************************************/
+
+int cmdHandlerInit(void)
+{
+
+	uint32_t idx;
+
+	for (idx = 0; idx < CMD_TABLE_SIZE; idx++)
+	{
+		CmdTable[idx].handler = NULL;
+		CmdTable[idx].n_calls = 0U;
+		CmdTable[idx].min_time = 0xFFFFFFFFU;
+		CmdTable[idx].max_time = 0U;
+		CmdTable[idx].total_time = 0U;
+	}
+
+	return XST_SUCCESS;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		cmdRegisterCommands()
+*
+* Description:	Registers the single-word commands handled by the command
+* 				handler itself (WRITE_WORD, READ_WORD, GET_CMD_STATS and the
+* 				read-modify-write commands).
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if a registration failed.
+*
+* Notes:		Not called on the comms core of the AMP build: these
+* 				commands access the memory and registers of the real-time
+* 				core, so they are executed there (see setCommandRemote()).
+*
+****************************************************************************/
+
+int cmdRegisterCommands(void)
+{
+
+	int status = XST_SUCCESS;
+
+	status |= registerCommand(WRITE_WORD, writeWordCmd);
+	status |= registerCommand(READ_WORD, readWordCmd);
+	status |= registerCommand(GET_CMD_STATS, getCmdStatsCmd);
+	status |= registerCommand(SET_BITS, setBitsCmd);
+	status |= registerCommand(CLEAR_BITS, clearBitsCmd);
+	status |= registerCommand(TOGGLE_BITS, toggleBitsCmd);
+
+	return (status == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		registerCommand()
+*
+* Description:	Adds a handler for a single-word command to the registry.
+*
+* param[in]		cmd: Command code (must be below CMD_TABLE_SIZE).
+* param[in]		handler: Function called with FIELD 1 and FIELD 2; its return
+* 				value is sent back to the host.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if the code is out of range, the
+* 				handler is NULL or the code is already registered.
+*
+* Notes:		Called by the modules that own commands, at initialisation.
+*
+****************************************************************************/
+
+int registerCommand(uint16_t cmd, cmd_handler_t handler)
+{
+
+	if ((cmd >= CMD_TABLE_SIZE) || (handler == NULL)
+			|| (CmdTable[cmd].handler != NULL))
+	{
+		return XST_FAILURE;
+	}
+
+	CmdTable[cmd].handler = handler;
+	return XST_SUCCESS;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		getCommandPayloadSize()
+*
+* Description:	Checks a received 10-byte frame to see if further payload bytes
+* 				must be received before the command can be handled. The
+* 				following frame types carry a payload:
+* 				BATCH: N x 10-byte command records.
+* 				WRITE_BLOCK, SEQ_LOAD: N x 4-byte data words plus a 4-byte checksum.
+* 				MASKED_WRITE: one 4-byte value word.
+* 				WAIT_FOR: 4-byte value and timeout words.
+*
+* param[in]		*rx_buffer: Pointer to the receive buffer in the comms block.
+*
+* Returns:		Number of payload bytes still to be received. Returns 0 for
+* 				ordinary frames, and for BATCH/WRITE_BLOCK frames with an
+* 				invalid count (these are rejected by handleCommand()).
+*
+* Notes:		Called by the frame parser and the comms block, in between
+* 				commands. The decoded frame (p_cmd_frame) is not used, so the
+* 				function does not depend on the command being handled.
+*
+****************************************************************************/
+
+uint32_t getCommandPayloadSize(uint8_t *rx_buffer)
+{
+
+	uint32_t n_records;
+	uint32_t n_words;
+	uint16_t cmd = (uint16_t)(((uint32_t)rx_buffer[0] << 8) | rx_buffer[1]);
+
+	switch (cmd)
+	{
+	case BATCH:
+		n_records = getWordFromBytes(&rx_buffer[2]);
+		if ((n_records == 0U) || (n_records > CMD_BATCH_MAX_RECORDS))
+		{
+			return 0U;
+		}
+		return (n_records * CMD_FRAME_NBYTES);
+
+	case WRITE_BLOCK:
+	case SEQ_LOAD:
+		/* N data words plus the checksum word */
+		n_words = getWordFromBytes(&rx_buffer[6]);
+		if ((n_words == 0U) || (n_words > CMD_BLOCK_MAX_WORDS))
+		{
+			return 0U;
+		}
+		return ((n_words + 1U) * 4U);
+
+	case MASKED_WRITE:
+		return CMD_MASKED_WRITE_NBYTES;
+
+	case WAIT_FOR:
+		return CMD_WAIT_FOR_NBYTES;
+
+	default:
+		return 0U;
+	}
+
+}
+
+
+
 /******************************************************************************
 *
 * Function:		handleCommand()
@@ -72,24 +259,209 @@ static void setResponseBytes(uint8_t *tx_buffer, uint32_t tx_data);
 * Description:	Main function for command handling. Effectively a wrapper around
 * 				the local functions decodeRxData() and executeCommand().
 *
+* 				For a BATCH frame, the N command records following the header
+* 				frame are decoded and executed in order, and the responses are
+* 				packed into the transmit buffer (4 bytes per record). Nested
+* 				BATCH records and block commands inside a BATCH are treated as
+* 				unknown commands.
+*
+* 				READ_BLOCK and WRITE_BLOCK are handled by executeReadBlock()
+* 				and executeWriteBlock() since their response/payload sizes
+* 				depend on the word count.
+* 				MASKED_WRITE takes its value word from the payload.
+* 				WAIT_FOR is passed to waitForStart(); if the condition is not
+* 				already true, the response is sent later (see wait_for.c).
+* 				SEQ_LOAD and SEQ_READ_RESULTS are passed to the sequencer.
+*
 * param[in]		*rx_buffer: Pointer to the receive buffer in the comms block.
 * param[in]		*tx_buffer: Pointer to the transmit buffer in the comms block.
+* param[in]		request_id: Identifies the request to the comms block (e.g.
+* 				the frame tag); only used for deferred responses.
 *
-* Returns:		None.
+* Returns:		Number of response bytes written to the transmit buffer.
+* 				0 = the response is deferred, and will be sent with
+* 				sendDeferredResponse().
 *
 * Notes:		This is the interface function that is called by external code
 * 				so that command handling is carried out. In this program, it is
-* 				called by the ISR in 'ps7_uart1_if.c'
+* 				called from the main loop (see uart1ServiceCommands() in
+* 				'ps7_uart1_if.c'). The receive buffer must
+* 				hold the frame plus its payload (see getCommandPayloadSize()),
+* 				and the transmit buffer must hold CMD_MAX_RESPONSE_NBYTES.
+* 				On the comms core of the AMP build, the frames this core
+* 				cannot execute are passed to the other core (see
+* 				setCommandRemote()).
 *
 ****************************************************************************/
 
-void handleCommand(uint8_t *rx_buffer, uint8_t *tx_buffer)
+uint32_t handleCommand(uint8_t *rx_buffer, uint8_t *tx_buffer, uint32_t request_id)
 {
 
-	/* Decode the receive data and execute the command */
+	uint32_t n_records;
+	uint32_t idx;
+	uint8_t *p_record;
+
+	/* Decode the receive data */
 	decodeRxData(rx_buffer);
-	executeCommand(tx_buffer);
 
+	/* AMP: frames for the other core. That is, every frame with a payload
+	 * or a variable-length response, and single-word commands that are not
+	 * registered here. BATCH records are passed on one by one, below. */
+	if ((p_remote != NULL) && (p_cmd_frame->cmd != BATCH)
+			&& ((p_cmd_frame->cmd >= CMD_TABLE_SIZE) || (CmdTable[p_cmd_frame->cmd].handler == NULL)))
+	{
+		return p_remote(rx_buffer, CMD_FRAME_NBYTES + getCommandPayloadSize(rx_buffer),
+						tx_buffer, CMD_MAX_RESPONSE_NBYTES, request_id);
+	}
+
+	/* Block frames: variable-length response */
+	if (p_cmd_frame->cmd == READ_BLOCK)
+	{
+		return executeReadBlock(tx_buffer);
+	}
+	else if (p_cmd_frame->cmd == WRITE_BLOCK)
+	{
+		return executeWriteBlock(rx_buffer + CMD_FRAME_NBYTES, tx_buffer);
+	}
+	else if (p_cmd_frame->cmd == MASKED_WRITE)
+	{
+		/* Only the bits set in the mask (field 2) are written */
+		setResponseBytes(tx_buffer, modifyRegister(p_cmd_frame->field1, ~p_cmd_frame->field2,
+						getWordFromBytes(rx_buffer + CMD_FRAME_NBYTES) & p_cmd_frame->field2));
+		return RESPONSE_NBYTES;
+	}
+	else if (p_cmd_frame->cmd == WAIT_FOR)
+	{
+		return waitForStart(p_cmd_frame->field1, p_cmd_frame->field2,
+							getWordFromBytes(rx_buffer + CMD_FRAME_NBYTES),
+							getWordFromBytes(rx_buffer + CMD_FRAME_NBYTES + 4U),
+							request_id, tx_buffer);
+	}
+	else if (p_cmd_frame->cmd == SEQ_LOAD)
+	{
+		return executeSeqLoad(rx_buffer + CMD_FRAME_NBYTES, tx_buffer);
+	}
+	else if (p_cmd_frame->cmd == SEQ_READ_RESULTS)
+	{
+		return seqReadResults(p_cmd_frame->field1, p_cmd_frame->field2, tx_buffer);
+	}
+
+	/* Ordinary frame: execute the command */
+	if (p_cmd_frame->cmd != BATCH)
+	{
+		executeCommand(tx_buffer);
+		return RESPONSE_NBYTES;
+	}
+
+	/* BATCH frame: reject an invalid record count */
+	n_records = p_cmd_frame->field1;
+	if ((n_records == 0U) || (n_records > CMD_BATCH_MAX_RECORDS))
+	{
+		setResponseBytes(tx_buffer, CMD_ERROR);
+		return RESPONSE_NBYTES;
+	}
+
+	/* Execute each record; records start after the header frame. A record
+	 * is a single-word command: frame commands (block, payload, deferred)
+	 * read CMD_ERROR, here and on the other core (see executeCommand()). */
+	for (idx = 0; idx < n_records; idx++)
+	{
+		p_record = rx_buffer + ((idx + 1U) * CMD_FRAME_NBYTES);
+		decodeRxData(p_record);
+
+		if (isFrameCommand(p_cmd_frame->cmd) != 0U)
+		{
+			setResponseBytes(tx_buffer + (idx * RESPONSE_NBYTES), CMD_ERROR);
+		}
+		else if ((p_remote != NULL)
+				&& ((p_cmd_frame->cmd >= CMD_TABLE_SIZE) || (CmdTable[p_cmd_frame->cmd].handler == NULL)))
+		{
+			(void)p_remote(p_record, CMD_FRAME_NBYTES, tx_buffer + (idx * RESPONSE_NBYTES),
+							RESPONSE_NBYTES, CMD_REQUEST_ID_NONE);
+		}
+		else
+		{
+			executeCommand(tx_buffer + (idx * RESPONSE_NBYTES));
+		}
+	}
+
+	return (n_records * RESPONSE_NBYTES);
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		setCommandResponder()
+*
+* Description:	Sets the comms block function used to send deferred responses.
+*
+* param[in]		responder: Comms block function (NULL = none).
+*
+* Returns:		None.
+*
+* Notes:		Called at start-up, after cmdHandlerInit().
+*
+****************************************************************************/
+
+void setCommandResponder(cmd_responder_t responder)
+{
+	p_responder = responder;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		sendDeferredResponse()
+*
+* Description:	Sends a response that was deferred by handleCommand().
+*
+* param[in]		request_id: The request_id passed to handleCommand().
+* param[in]		*response: Response bytes.
+* param[in]		n_bytes: Number of response bytes.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if there is no responder or the
+* 				response cannot be queued yet (try again later).
+*
+* Notes:		Must be called from the same context as handleCommand(), i.e.
+* 				the main loop.
+*
+****************************************************************************/
+
+int sendDeferredResponse(uint32_t request_id, uint8_t *response, uint32_t n_bytes)
+{
+	if (p_responder == NULL)
+	{
+		return XST_FAILURE;
+	}
+
+	return p_responder(request_id, response, n_bytes);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		setCommandRemote()
+*
+* Description:	Sets the function that executes commands on another core
+* 				(AMP, see amp.h).
+*
+* param[in]		remote: Remote function (NULL = none: unregistered commands
+* 				return CMD_ERROR).
+*
+* Returns:		None.
+*
+* Notes:		Called at start-up on the comms core. handleCommand() then
+* 				passes to it every frame that this core cannot execute.
+*
+****************************************************************************/
+
+void setCommandRemote(cmd_remote_t remote)
+{
+	p_remote = remote;
 }
 
 
@@ -152,11 +524,15 @@ void decodeRxData(uint8_t *rx_buffer){
 * Description:	Executes the received command and directly updates the comms
 * 				block transmit buffer with the response data.
 *
+* 				The handler is looked up in the command registry using the
+* 				command code as the index. The handler is timed with the
+* 				Global Timer, and the entry statistics are updated.
+*
 * param[in]		*tx_buffer: Pointer to the transmit buffer in the comms block.
 *
 * Returns:		None.
 *
-* Notes:		None.
+* Notes:		Unknown or unregistered commands return CMD_ERROR.
 *
 ****************************************************************************/
 
@@ -168,62 +544,388 @@ void executeCommand(uint8_t *tx_buffer) {
 	uint32_t field1 = p_cmd_frame->field1;
 	uint32_t field2 = p_cmd_frame->field2;
 
-	/* Variable to store memory read data */
-	uint32_t mem_read_data;
+	cmd_entry_t *p_entry;
+	uint32_t response;
+	uint32_t exec_time;
+	XTime t_start;
+	XTime t_end;
 
 
-	/* ----- Switch-Case to handle the packet ----- */
-
-	switch(cmd) {
-
-	// --------------------------------------------------------------------------------- //
-	// WRITE_WORD: 32-bit write to memory location
-	// Field 1 = address ; Field 2 = Data
-	// --------------------------------------------------------------------------------- //
-	case WRITE_WORD:
-		/* Write the data and update the response buffer */
-		Xil_Out32(field1, field2);
-		setResponseBytes(tx_buffer, WRITE_OKAY);
-		break;
-
-
-	// --------------------------------------------------------------------------------- //
-	// CMD = 0x00D4: 32-bit read from memory location
-	// Field 1 = address
-	// --------------------------------------------------------------------------------- //
-	case READ_WORD:
-		/* Read the data and update the response buffer */
-		mem_read_data = Xil_In32(field1);
-		setResponseBytes(tx_buffer, mem_read_data);
-		break;
-
-
-	// --------------------------------------------------------------------------------- //
-	// CMD = 0x00F0: Used in shared variable test to clear LED1 and LED2.
-	// Field 1 and Field 2 are empty
-	// --------------------------------------------------------------------------------- //
-	case CLEAR_LEDS:
-		/* Clear the LEDs */
-		axiGpOutClear(LED1);
-		axiGpOutClear(LED2);
-		/* Update the response buffer */
-		setResponseBytes(tx_buffer, CLEAR_LEDS_RESP);
-		break;
-
-
-	// --------------------------------------------------------------------------------- //
-	// Handle unknown commands
-	// --------------------------------------------------------------------------------- //
-	default:
+	/* ----- Handle unknown commands ----- */
+	if ((cmd >= CMD_TABLE_SIZE) || (CmdTable[cmd].handler == NULL))
+	{
 		/* Update the response buffer with error code */
 		setResponseBytes(tx_buffer, CMD_ERROR);
-		break;
+		return;
+	}
+
+
+	/* ----- Call the registered handler, and time it ----- */
+	p_entry = &CmdTable[cmd];
+
+	XTime_GetTime(&t_start);
+	response = p_entry->handler(field1, field2);
+	XTime_GetTime(&t_end);
+
+	setResponseBytes(tx_buffer, response);
+
+
+	/* ----- Update statistics ----- */
+	exec_time = (uint32_t)(t_end - t_start);
+
+	p_entry->n_calls++;
+	p_entry->total_time += exec_time;
+	if (exec_time < p_entry->min_time)
+	{
+		p_entry->min_time = exec_time;
+	}
+	if (exec_time > p_entry->max_time)
+	{
+		p_entry->max_time = exec_time;
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		writeWordCmd()
+*
+* Description:	WRITE_WORD: 32-bit write to memory location.
+* 				Field 1 = address ; Field 2 = Data
+*
+* Returns:		WRITE_OKAY.
+*
+****************************************************************************/
+
+uint32_t writeWordCmd(uint32_t field1, uint32_t field2)
+{
+	Xil_Out32(field1, field2);
+	return WRITE_OKAY;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		readWordCmd()
+*
+* Description:	READ_WORD: 32-bit read from memory location.
+* 				Field 1 = address
+*
+* Returns:		The data read.
+*
+****************************************************************************/
+
+uint32_t readWordCmd(uint32_t field1, uint32_t field2)
+{
+	return Xil_In32(field1);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		setBitsCmd() / clearBitsCmd() / toggleBitsCmd()
+*
+* Description:	SET_BITS / CLEAR_BITS / TOGGLE_BITS: atomic read-modify-write
+* 				of a 32-bit register.
+* 				Field 1 = address ; Field 2 = mask of the bits to change
+*
+* Returns:		The register value before the write.
+*
+****************************************************************************/
+
+uint32_t setBitsCmd(uint32_t field1, uint32_t field2)
+{
+	return modifyRegister(field1, ~field2, field2);
+}
+
+uint32_t clearBitsCmd(uint32_t field1, uint32_t field2)
+{
+	return modifyRegister(field1, ~field2, 0U);
+}
+
+uint32_t toggleBitsCmd(uint32_t field1, uint32_t field2)
+{
+	return modifyRegister(field1, 0xFFFFFFFFU, field2);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		modifyRegister()
+*
+* Description:	Read-modify-write of a 32-bit register:
+* 				new value = (old value & and_mask) ^ xor_mask
+*
+* 				IRQs are disabled for the read and the write only, so an ISR
+* 				cannot update the register in between. If IRQs were already
+* 				disabled by the caller, they stay disabled.
+*
+* param[in]		address: Register address.
+* param[in]		and_mask: Bits of the old value to keep.
+* param[in]		xor_mask: Bits to invert after the AND.
+*
+* Returns:		The register value before the write.
+*
+* Notes:		SET = (~m, m); CLEAR = (~m, 0); TOGGLE = (0xFFFFFFFF, m);
+* 				MASKED_WRITE = (~m, value & m).
+*
+****************************************************************************/
+
+uint32_t modifyRegister(uint32_t address, uint32_t and_mask, uint32_t xor_mask)
+{
+
+	uint32_t irq_was_disabled = mfcpsr() & XIL_EXCEPTION_IRQ;
+	uint32_t old_value;
+
+	Xil_ExceptionDisable();
+
+	old_value = Xil_In32(address);
+	Xil_Out32(address, (old_value & and_mask) ^ xor_mask);
+
+	if (irq_was_disabled == 0U)
+	{
+		Xil_ExceptionEnable();
+	}
+
+	return old_value;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		getCmdStatsCmd()
+*
+* Description:	GET_CMD_STATS: Reads one statistic of a registry entry.
+* 				Field 1 = command code; Field 2 = selector:
+* 				CMD_STATS_COUNT:	number of invocations.
+* 				CMD_STATS_MIN:		minimum execution time.
+* 				CMD_STATS_MAX:		maximum execution time.
+* 				CMD_STATS_TOTAL_LO:	total execution time, bits [31:0].
+* 				CMD_STATS_TOTAL_HI:	total execution time, bits [63:32].
+* 				CMD_STATS_CLEAR:	clears the statistics of the entry.
+*
+* Returns:		The statistic (times in Global Timer counts), WRITE_OKAY for
+* 				CMD_STATS_CLEAR, or CMD_ERROR for an unregistered command or
+* 				an unknown selector.
+*
+****************************************************************************/
+
+uint32_t getCmdStatsCmd(uint32_t field1, uint32_t field2)
+{
+
+	cmd_entry_t *p_entry;
+
+	if ((field1 >= CMD_TABLE_SIZE) || (CmdTable[field1].handler == NULL))
+	{
+		return CMD_ERROR;
+	}
+
+	p_entry = &CmdTable[field1];
+
+	switch (field2)
+	{
+	case CMD_STATS_COUNT:
+		return p_entry->n_calls;
+
+	case CMD_STATS_MIN:
+		return (p_entry->n_calls == 0U) ? 0U : p_entry->min_time;
+
+	case CMD_STATS_MAX:
+		return p_entry->max_time;
+
+	case CMD_STATS_TOTAL_LO:
+		return (uint32_t)(p_entry->total_time & 0xFFFFFFFFU);
+
+	case CMD_STATS_TOTAL_HI:
+		return (uint32_t)(p_entry->total_time >> 32);
+
+	case CMD_STATS_CLEAR:
+		p_entry->n_calls = 0U;
+		p_entry->min_time = 0xFFFFFFFFU;
+		p_entry->max_time = 0U;
+		p_entry->total_time = 0U;
+		return WRITE_OKAY;
+
+	default:
+		return CMD_ERROR;
+	}
+
+}
+
+
+
+
+/******************************************************************************
+*
+* Function:		executeReadBlock()
+*
+* Description:	Executes READ_BLOCK. Reads N consecutive 32-bit words starting
+* 				at FIELD 1 (N = FIELD 2) into the transmit buffer, followed by
+* 				the checksum of the words.
+*
+* param[in]		*tx_buffer: Pointer to the transmit buffer in the comms block.
+*
+* Returns:		Number of response bytes: (N + 1) x 4, or 4 if N is invalid
+* 				(CMD_ERROR response).
+*
+* Notes:		None.
+*
+****************************************************************************/
+
+uint32_t executeReadBlock(uint8_t *tx_buffer)
+{
+
+	uint32_t address = p_cmd_frame->field1;
+	uint32_t n_words = p_cmd_frame->field2;
+	uint32_t checksum = 0U;
+	uint32_t mem_read_data;
+	uint32_t idx;
+
+	if ((n_words == 0U) || (n_words > CMD_BLOCK_MAX_WORDS))
+	{
+		setResponseBytes(tx_buffer, CMD_ERROR);
+		return RESPONSE_NBYTES;
 	}
 
+	for (idx = 0; idx < n_words; idx++)
+	{
+		mem_read_data = Xil_In32(address + (idx * 4U));
+		checksum += mem_read_data;
+		setResponseBytes(tx_buffer + (idx * 4U), mem_read_data);
+	}
+
+	setResponseBytes(tx_buffer + (n_words * 4U), checksum);
+
+	return ((n_words + 1U) * 4U);
+
 }
 
 
 
+/******************************************************************************
+*
+* Function:		executeWriteBlock()
+*
+* Description:	Executes WRITE_BLOCK. The checksum of the N payload words is
+* 				verified first; if it matches, the words are written to N
+* 				consecutive 32-bit locations starting at FIELD 1 (N = FIELD 2).
+*
+* param[in]		*payload: Pointer to the data words following the frame.
+* param[in]		*tx_buffer: Pointer to the transmit buffer in the comms block.
+*
+* Returns:		Number of response bytes (always 4). The response is WRITE_OKAY,
+* 				CHECKSUM_ERROR (nothing written) or CMD_ERROR (invalid N).
+*
+* Notes:		None.
+*
+****************************************************************************/
+
+uint32_t executeWriteBlock(uint8_t *payload, uint8_t *tx_buffer)
+{
+
+	uint32_t address = p_cmd_frame->field1;
+	uint32_t n_words = p_cmd_frame->field2;
+	uint32_t idx;
+
+	if ((n_words == 0U) || (n_words > CMD_BLOCK_MAX_WORDS))
+	{
+		setResponseBytes(tx_buffer, CMD_ERROR);
+		return RESPONSE_NBYTES;
+	}
+
+	/* Verify the checksum before touching memory */
+	if (checkPayloadChecksum(payload, n_words) == 0U)
+	{
+		setResponseBytes(tx_buffer, CHECKSUM_ERROR);
+		return RESPONSE_NBYTES;
+	}
+
+	for (idx = 0; idx < n_words; idx++)
+	{
+		Xil_Out32(address + (idx * 4U), getWordFromBytes(payload + (idx * 4U)));
+	}
+
+	setResponseBytes(tx_buffer, WRITE_OKAY);
+	return RESPONSE_NBYTES;
+
+}
+
+
+
+
+/******************************************************************************
+*
+* Function:		executeSeqLoad()
+*
+* Description:	Executes SEQ_LOAD. The payload is formatted as for WRITE_BLOCK;
+* 				if the checksum matches, the N words (4N program bytes) are
+* 				copied to the sequencer program at byte offset FIELD 1.
+*
+* param[in]		*payload: Pointer to the data words following the frame.
+* param[in]		*tx_buffer: Pointer to the transmit buffer in the comms block.
+*
+* Returns:		Number of response bytes (always 4). The response is WRITE_OKAY,
+* 				CHECKSUM_ERROR or CMD_ERROR (invalid N, offset or sequencer armed).
+*
+****************************************************************************/
+
+uint32_t executeSeqLoad(uint8_t *payload, uint8_t *tx_buffer)
+{
+
+	uint32_t n_words = p_cmd_frame->field2;
+
+	if ((n_words == 0U) || (n_words > CMD_BLOCK_MAX_WORDS))
+	{
+		setResponseBytes(tx_buffer, CMD_ERROR);
+	}
+	else if (checkPayloadChecksum(payload, n_words) == 0U)
+	{
+		setResponseBytes(tx_buffer, CHECKSUM_ERROR);
+	}
+	else
+	{
+		setResponseBytes(tx_buffer, seqLoadProgram(p_cmd_frame->field1, payload, n_words * 4U));
+	}
+
+	return RESPONSE_NBYTES;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		checkPayloadChecksum()
+*
+* Description:	Checks the checksum word that follows N payload words.
+*
+* Returns:		1 if the checksum matches, otherwise 0.
+*
+****************************************************************************/
+
+uint32_t checkPayloadChecksum(uint8_t *payload, uint32_t n_words)
+{
+
+	uint32_t checksum = 0U;
+	uint32_t idx;
+
+	for (idx = 0; idx < n_words; idx++)
+	{
+		checksum += getWordFromBytes(payload + (idx * 4U));
+	}
+
+	return (checksum == getWordFromBytes(payload + (n_words * 4U))) ? 1U : 0U;
+
+}
+
+
 
 /******************************************************************************
 *
@@ -234,7 +936,8 @@ void executeCommand(uint8_t *tx_buffer) {
 *
 * Returns:		None.
 *
-* Notes:		None.
+* Notes:		Big-endian (MSB first). Also used by the modules that build
+* 				their own responses and frames (payloads, telemetry, log).
 *
 ****************************************************************************/
 
@@ -248,6 +951,51 @@ void setResponseBytes(uint8_t* tx_buffer, uint32_t tx_data)
 
 
 
+/******************************************************************************
+*
+* Function:		getWordFromBytes
+*
+* Description:	Converts 4 big-endian bytes from the receive buffer to a u32.
+*
+* Returns:		The 32-bit word.
+*
+* Notes:		None.
+*
+****************************************************************************/
+
+uint32_t getWordFromBytes(uint8_t *rx_buffer)
+{
+	return ( ((uint32_t)rx_buffer[0] << 24)
+			| ((uint32_t)rx_buffer[1] << 16)
+			| ((uint32_t)rx_buffer[2] << 8)
+			| (uint32_t)rx_buffer[3] );
+}
+
+
+
+/******************************************************************************
+*
+* Function:		isFrameCommand
+*
+* Description:	Checks for a command that handleCommand() executes as a whole
+* 				frame (payload, variable-length or deferred response), rather
+* 				than through the command table.
+*
+* Returns:		1 for a frame command, otherwise 0.
+*
+* Notes:		Frame commands are not valid as BATCH records.
+*
+****************************************************************************/
+
+uint32_t isFrameCommand(uint32_t cmd)
+{
+	return ( (cmd == BATCH) || (cmd == READ_BLOCK) || (cmd == WRITE_BLOCK)
+			|| (cmd == MASKED_WRITE) || (cmd == WAIT_FOR) || (cmd == SEQ_LOAD)
+			|| (cmd == SEQ_READ_RESULTS) ) ? 1U : 0U;
+}
+
+
+
 /****** End functions *****/
 
 /****** End of File **********************************************************/
@@ -36,24 +36,68 @@
 /***************************** Include Files *********************************/
 /*****************************************************************************/
 
+#ifdef HOST_BUILD
+/* Host build (see concurrency.h): types and status codes only */
+#include "concurrency.h"
+#else
 /* Xilinx files */
 #include "xil_types.h"
 #include "xil_io.h"
-
-/* Added for sw_proj10 */
-#include "../gpio/axi_gpio0_if.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#endif
 
 
 /*****************************************************************************/
 /************************** Constant Definitions *****************************/
 /*****************************************************************************/
 
+#define CMD_FRAME_NBYTES	10U
 #define RESPONSE_NBYTES		4U
 #define WRITE_OKAY			(0x01010101U)
 #define CMD_ERROR			(0xEEAA5577U)
 
-/* Added for sw_proj10 */
-#define CLEAR_LEDS_RESP		(0x03030303U)
+/* Maximum number of command records carried in one BATCH frame */
+#define CMD_BATCH_MAX_RECORDS	32U
+
+/* AMP: a BATCH record passed to the other core that was not answered in
+ * time. It may still run: unlike CMD_ERROR, it must not be sent again
+ * blindly (see ampCallCpu0()). */
+#define CMD_PENDING				(0xEEAA55EEU)
+
+/* Request ID of a command whose response cannot be deferred (a BATCH
+ * record); frame tags are 8-bit. */
+#define CMD_REQUEST_ID_NONE		(0xFFFFFFFFU)
+
+/* Maximum number of 32-bit words moved by one READ_BLOCK/WRITE_BLOCK */
+#define CMD_BLOCK_MAX_WORDS		256U
+#define CHECKSUM_ERROR			(0xEEAA55CCU)
+
+/* Largest payload following a 10-byte frame, and largest response.
+ * Both are set by the block commands (data words + checksum word). */
+#define CMD_MAX_PAYLOAD_NBYTES	((CMD_BLOCK_MAX_WORDS + 1U) * 4U)
+#define CMD_MAX_RESPONSE_NBYTES	((CMD_BLOCK_MAX_WORDS + 1U) * RESPONSE_NBYTES)
+
+/* Payload of MASKED_WRITE: the value word */
+#define CMD_MASKED_WRITE_NBYTES	4U
+
+/* Payload of WAIT_FOR: the value and timeout words */
+#define CMD_WAIT_FOR_NBYTES		8U
+#define WAIT_TIMEOUT			(0xEEAA55DDU)
+
+/* Size of the command registry. Command codes are used directly as the
+ * table index, so registered codes must be below CMD_TABLE_SIZE. */
+#define CMD_TABLE_SIZE			256U
+
+/* GET_CMD_STATS selectors (FIELD 2) */
+#define CMD_STATS_COUNT			0U
+#define CMD_STATS_MIN			1U
+#define CMD_STATS_MAX			2U
+#define CMD_STATS_TOTAL_LO		3U
+#define CMD_STATS_TOTAL_HI		4U
+#define CMD_STATS_CLEAR			5U
 
 
 /*****************************************************************************/
@@ -74,13 +118,180 @@ typedef struct {
 } cmd_frame;
 
 
+/* -------- Batch frame structure -------*/
+/*	A BATCH frame is an ordinary 10-byte frame with CMD = BATCH and
+*	FIELD 1 = number of records (N), followed by N ordinary 10-byte
+*	command records:
+*
+*	---------------------------------------------------------------
+*	| BATCH |   N   |   0   | RECORD 0 | RECORD 1 | ... | RECORD N-1 |
+*	---------------------------------------------------------------
+*
+*	The response is a packed vector of N 4-byte responses, in the
+*	same order as the records. In the AMP build, a record run on the other
+*	core that is not answered in time reads CMD_PENDING. */
+
+
+/* -------- Block frame structure -------*/
+/*	READ_BLOCK / WRITE_BLOCK use an ordinary 10-byte frame with
+*	FIELD 1 = start address and FIELD 2 = word count (N).
+*
+*	WRITE_BLOCK: the frame is followed by N data words and a checksum
+*	word. The response is WRITE_OKAY, or CHECKSUM_ERROR (no data written).
+*	-----------------------------------------------------------------
+*	| WRITE_BLOCK | ADDR | N | WORD 0 | ... | WORD N-1 | CHECKSUM |
+*	-----------------------------------------------------------------
+*
+*	READ_BLOCK: the response is N data words followed by a checksum word.
+*	-------------------------------------------
+*	| WORD 0 | WORD 1 | ... | WORD N-1 | CHECKSUM |
+*	-------------------------------------------
+*
+*	All words are big-endian. CHECKSUM is the 32-bit sum (modulo 2^32)
+*	of the N data words. */
+
+
+/* -------- Read-modify-write commands -------*/
+/*	SET_BITS / CLEAR_BITS / TOGGLE_BITS: FIELD 1 = address, FIELD 2 = mask.
+*
+*	MASKED_WRITE: FIELD 1 = address, FIELD 2 = mask, followed by a 4-byte
+*	value word. Only the bits set in the mask are written.
+*	-----------------------------------------
+*	| MASKED_WRITE | ADDR | MASK | VALUE |
+*	-----------------------------------------
+*
+*	The read and the write are done with interrupts disabled, so no ISR
+*	can update the register in between. The response is the register value
+*	before the write. MASKED_WRITE cannot be used inside a BATCH frame. */
+
+
+/* -------- WAIT_FOR -------*/
+/*	FIELD 1 = address, FIELD 2 = mask, followed by the expected value and
+*	a timeout in TTC0 cycles:
+*	---------------------------------------------
+*	| WAIT_FOR | ADDR | MASK | VALUE | TIMEOUT |
+*	---------------------------------------------
+*
+*	The target checks ((reg & MASK) == (VALUE & MASK)) once per TTC0 cycle
+*	and responds when the condition is true or the timeout expires. The
+*	response is 8 bytes:
+*	---------------------
+*	| STATUS | REG VALUE |
+*	---------------------
+*	STATUS = WRITE_OKAY (condition true) or WAIT_TIMEOUT. REG VALUE is the
+*	last value read. Other requests are handled while the wait is pending.
+*	WAIT_FOR cannot be used inside a BATCH frame. */
+
+
+
+/* -------- Command registry -------*/
+/*	Single-word commands are dispatched through a table indexed by the
+*	command code. Each module registers its own handlers at start-up
+*	(see registerCommand()). A handler receives FIELD 1 and FIELD 2 and
+*	returns the 4-byte response.
+*
+*	Each entry also records the number of invocations and the min, max
+*	and total execution time of the handler, in Global Timer counts
+*	(COUNTS_PER_SECOND, i.e. CPU clock / 2). */
+
+typedef uint32_t (*cmd_handler_t)(uint32_t field1, uint32_t field2);
+
+/* Sends a response that was deferred by handleCommand() (e.g. WAIT_FOR).
+ * Implemented by the comms block; returns XST_FAILURE if the response
+ * cannot be queued yet. */
+typedef int (*cmd_responder_t)(uint32_t request_id, uint8_t *response, uint32_t n_bytes);
+
+/* Executes a command frame (and its payload) on another core (AMP, see
+ * amp.h) and returns the number of response bytes, as handleCommand().
+ * Used for the commands that are not registered on this core. tx_nbytes is
+ * the space in tx_buffer: a longer response is replaced by CMD_ERROR.
+ * request_id is the frame tag of a deferred response (0 bytes), or
+ * CMD_REQUEST_ID_NONE if the response cannot be deferred. */
+typedef uint32_t (*cmd_remote_t)(uint8_t *rx_buffer, uint32_t n_bytes, uint8_t *tx_buffer,
+									uint32_t tx_nbytes, uint32_t request_id);
+
+typedef struct {
+	cmd_handler_t handler;
+	volatile uint32_t n_calls;
+	volatile uint32_t min_time;
+	volatile uint32_t max_time;
+	volatile uint64_t total_time;
+} cmd_entry_t;
+
+
 
 /* -------- Commands -------- */
+/* Codes of the commands handled in this project. Handlers for single-word
+ * commands are registered by the module that owns them. */
 typedef enum
 {
 	WRITE_WORD = 0x00D3,
 	READ_WORD = 0x00D4,
 
+	// Contiguous block transfers:
+	READ_BLOCK = 0x00D5,
+	WRITE_BLOCK = 0x00D6,
+
+	// Atomic read-modify-write:
+	SET_BITS = 0x00D7,
+	CLEAR_BITS = 0x00D8,
+	TOGGLE_BITS = 0x00D9,
+	MASKED_WRITE = 0x00DA,
+
+	// Condition wait with timeout (deferred response):
+	WAIT_FOR = 0x00DB,
+
+	// Register-op sequencer (see sequencer.h):
+	// SEQ_LOAD: Field 1 = byte offset; Field 2 = N words (payload as WRITE_BLOCK)
+	// SEQ_READ_RESULTS: Field 1 = first word; Field 2 = N (response as READ_BLOCK)
+	SEQ_LOAD = 0x00A0,
+	SEQ_RUN = 0x00A1,
+	SEQ_STOP = 0x00A2,
+	SEQ_STATUS = 0x00A3,
+	SEQ_READ_RESULTS = 0x00A4,
+
+	// Telemetry subscriptions (see telemetry.h):
+	// SUBSCRIBE_xxx: Field 1 = address; Field 2 = period in TTC0 cycles
+	// UNSUBSCRIBE: Field 1 = subscription ID (TELEM_ALL = all)
+	SUBSCRIBE_PERIODIC = 0x00A8,
+	SUBSCRIBE_ON_CHANGE = 0x00A9,
+	UNSUBSCRIBE = 0x00AA,
+	GET_TELEM_STATS = 0x00AB,
+
+	// Container for multiple command records:
+	BATCH = 0x00B0,
+
+	// Command registry statistics:
+	// Field 1 = command code; Field 2 = selector (CMD_STATS_xxx)
+	GET_CMD_STATS = 0x00C0,
+	GET_FRAME_STATS = 0x00C1,
+
+	// UART baud rate negotiation (see ps7_uart1_if.h):
+	// SET_BAUD: Field 1 = new rate; Field 2 = verify timeout (TTC0 cycles)
+	// BAUD_CONFIRM: response = current rate
+	SET_BAUD = 0x00C2,
+	BAUD_CONFIRM = 0x00C3,
+
+	// UART receive error counters:
+	// Field 1 = selector (UART_LINK_STATS_xxx)
+	GET_LINK_STATS = 0x00C4,
+
+	// Deferred logger statistics (see logger.h):
+	// Field 1 = selector (LOG_STATS_xxx)
+	GET_LOG_STATS = 0x00C5,
+
+	// Scheduler task profiles (see scheduler.h):
+	// Field 1 = task ID; Field 2 = selector (SCHED_PROF_xxx)
+	GET_TASK_PROFILE = 0x00C6,
+
+	// Idle mode statistics (see idle.h):
+	// Field 1 = selector (IDLE_STATS_xxx)
+	GET_IDLE_STATS = 0x00C7,
+
+	// Scheduler tick phase error (see ttc0_if.h):
+	// Field 1 = selector (TTC0_STATS_xxx)
+	GET_TICK_STATS = 0x00C8,
+
 	// ADDED FOR SHARED VAR TEST:
 	CLEAR_LEDS = 0xF0
 }commands;
@@ -101,8 +312,27 @@ typedef enum
 /************************** Function Prototypes ******************************/
 /*****************************************************************************/
 
-/* Main function to be used by comms block ISR */
-void handleCommand(uint8_t *rx_buffer, uint8_t *tx_buffer);
+/* Initialisation and command registration */
+int cmdHandlerInit(void);
+int cmdRegisterCommands(void);
+int registerCommand(uint16_t cmd, cmd_handler_t handler);
+
+/* Main functions to be used by comms block */
+uint32_t getCommandPayloadSize(uint8_t *rx_buffer);
+uint32_t handleCommand(uint8_t *rx_buffer, uint8_t *tx_buffer, uint32_t request_id);
+
+/* Register access helpers */
+uint32_t modifyRegister(uint32_t address, uint32_t and_mask, uint32_t xor_mask);
+
+/* Response helpers */
+void setResponseBytes(uint8_t *tx_buffer, uint32_t tx_data);
+
+/* Deferred responses */
+void setCommandResponder(cmd_responder_t responder);
+int sendDeferredResponse(uint32_t request_id, uint8_t *response, uint32_t n_bytes);
+
+/* Commands executed on another core (AMP) */
+void setCommandRemote(cmd_remote_t remote);
 
 
 #endif /* SRC_CMD_HANDLER_H_ */
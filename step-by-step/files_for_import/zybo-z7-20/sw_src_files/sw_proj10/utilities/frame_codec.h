@@ -0,0 +1,149 @@
+/******************************************************************************
+ * @Title		:	Frame Codec (Header File)
+ * @Filename	:	frame_codec.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+#ifndef SRC_UTILITIES_FRAME_CODEC_H_
+#define SRC_UTILITIES_FRAME_CODEC_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#ifdef HOST_BUILD
+/* Host build (see concurrency.h): types and status codes only */
+#include "concurrency.h"
+#else
+/* Xilinx files */
+#include "xil_types.h"
+#include "xstatus.h"
+#endif
+
+/* Command handler (frame sizes, command registration) */
+#include "cmd_handler.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* Wire format:
+ * 1 = Framed protocol (SOF + LEN + PAYLOAD + CRC16), see below.
+ * 0 = Original unframed protocol: the 10-byte command frame (plus any
+ *     BATCH/WRITE_BLOCK payload) is sent as-is, and responses are unframed.
+ *     Use this with the LabVIEW host application from the book. */
+#define FRAME_PROTOCOL_FRAMED		1
+
+
+/* -------- Framed protocol -------*/
+/*	-----------------------------------------------------------------
+*	| SOF | LEN (2) | TAG |       PAYLOAD (LEN bytes)      | CRC (2) |
+*	-----------------------------------------------------------------
+*
+*	SOF = 0x7E. LEN and CRC are big-endian.
+*	TAG = sequence tag chosen by the host. The target copies the TAG of
+*	each request into its response, so the host can have several requests
+*	in flight (up to UART_RX_RING_SIZE bytes) and match responses by tag.
+*	TAG = FRAME_TAG_UNSOLICITED and FRAME_TAG_LOG are reserved for frames
+*	the target sends without a request (telemetry, see telemetry.h, and log
+*	records, see logger.h); the host must not use them.
+*	PAYLOAD = a command frame (plus any payload) from the host, or a
+*	response from the target.
+*	CRC = CRC-16/CCITT (poly 0x1021, init 0xFFFF) over LEN, TAG and PAYLOAD.
+*
+*	The receiver parses the stream one byte at a time. A frame with an
+*	invalid LEN or a bad CRC is discarded, and the bytes following its SOF
+*	are searched again for the next SOF, so the receiver resynchronises on
+*	the next valid frame without a reset. */
+
+#define FRAME_SOF					0x7EU
+#define FRAME_TAG_UNSOLICITED		0xFFU
+#define FRAME_TAG_LOG				0xFEU
+
+#if FRAME_PROTOCOL_FRAMED
+#define FRAME_HEADER_NBYTES			4U		// SOF + LEN + TAG
+#define FRAME_CRC_NBYTES			2U
+#else
+#define FRAME_HEADER_NBYTES			0U
+#define FRAME_CRC_NBYTES			0U
+#endif
+
+/* Largest payload in either direction */
+#define FRAME_MAX_PAYLOAD			(CMD_FRAME_NBYTES + CMD_MAX_PAYLOAD_NBYTES)
+
+/* Largest frame on the wire */
+#define FRAME_MAX_NBYTES			(FRAME_HEADER_NBYTES + FRAME_MAX_PAYLOAD + FRAME_CRC_NBYTES)
+
+
+/* GET_FRAME_STATS selectors (FIELD 1) */
+#define FRAME_STATS_FRAMES			0U
+#define FRAME_STATS_CRC_ERRORS		1U
+#define FRAME_STATS_FRAMING_ERRORS	2U
+#define FRAME_STATS_DROPPED			3U
+#define FRAME_STATS_CLEAR			4U
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* Receive statistics */
+typedef struct {
+	volatile uint32_t n_frames;			// Valid frames received
+	volatile uint32_t crc_errors;		// Frames discarded due to bad CRC
+	volatile uint32_t framing_errors;	// Invalid LEN, or LEN not matching the command
+	volatile uint32_t dropped;			// Receive ring overflows (bytes lost)
+} frame_stats_t;
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Initialisation */
+void frameParserReset(void);
+int frameRegisterCommands(void);
+
+/* Receive */
+uint32_t frameRxByte(uint8_t byte);
+uint32_t frameRxIdle(void);
+uint32_t frameConsume(void);
+uint8_t *frameGetPayload(void);
+uint32_t frameGetPayloadSize(void);
+uint8_t frameGetTag(void);
+void frameCountFramingError(void);
+void frameCountDropped(void);
+
+/* Transmit */
+uint32_t frameEncode(uint8_t *tx_buffer, uint32_t n_bytes_payload, uint8_t tag);
+
+/* General */
+uint16_t crc16Ccitt(uint16_t crc, const uint8_t *data, uint32_t n_bytes);
+
+
+#endif /* SRC_UTILITIES_FRAME_CODEC_H_ */
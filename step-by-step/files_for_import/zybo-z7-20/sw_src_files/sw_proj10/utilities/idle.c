@@ -0,0 +1,389 @@
+/******************************************************************************
+ * @Title		:	Idle Mode
+ * @Filename	:	idle.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include "idle.h"
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* The core is in idleWait() (set by the main loop, cleared by the TTC0 ISR
+ * or by idleWait() on return) */
+static volatile uint32_t idle_asleep = 0U;
+
+/* Sleeps, and Global Timer counts spent asleep (main loop) */
+static uint32_t			idle_n_sleeps = 0U;
+static uint64_t			idle_sleep_time = 0U;
+
+/* Global Timer count when the statistics were cleared */
+static XTime			idle_t_clear = 0U;
+
+/* Tick latency, with the core asleep and awake (TTC0 ISR). The ISR is the
+ * only writer: the command reads them under the seqlock, and asks the ISR
+ * to clear them. */
+static idle_latency_t	IdleWake = { 0U, 0xFFFFFFFFU, 0U, 0U, 0U };
+static idle_latency_t	IdleBusy = { 0U, 0xFFFFFFFFU, 0U, 0U, 0U };
+static seqlock_t		IdleLatencyLock;
+static volatile uint32_t idle_lat_clear = 0U;	// Set by command, cleared by ISR
+
+
+
+/****************************************************************************/
+/************************** Function Prototypes *****************************/
+/****************************************************************************/
+
+/* Command handlers */
+static uint32_t idleStatsCmd(uint32_t field1, uint32_t field2);
+
+/* Functions internal to this file */
+static void idleLatencyAdd(idle_latency_t *p_lat, uint32_t latency);
+static void idleLatencyClear(idle_latency_t *p_lat);
+static uint32_t idleLatencyRead(const idle_latency_t *p_lat, uint32_t selector);
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		idleRegisterCommands()
+*
+* Description:	Registers GET_IDLE_STATS with the command handler.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if registration failed.
+*
+* Notes:		cmdHandlerInit() must be called first.
+*
+****************************************************************************/
+
+int idleRegisterCommands(void)
+{
+	return registerCommand(GET_IDLE_STATS, idleStatsCmd);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		idleWait()
+*
+* Description:	Stops the core (WFI) until the next interrupt, unless work is
+* 				waiting. See idle.h.
+*
+* param[in]		work_pending: Returns non-zero if the main loop has work
+* 				waiting. Called with interrupts disabled.
+*
+* Returns:		1 if the core slept, 0 if work was waiting (or IDLE_WFI is 0).
+*
+* Notes:		Called from the main loop only, with interrupts enabled; they
+* 				are enabled again on return.
+*
+****************************************************************************/
+
+uint32_t idleWait(idle_check_t work_pending)
+{
+
+#if IDLE_WFI
+	XTime t_sleep;
+	XTime t_wake;
+
+	Xil_ExceptionDisable();
+
+	if (work_pending() != 0U)
+	{
+		Xil_ExceptionEnable();
+		return 0U;
+	}
+
+	idle_asleep = 1U;
+	XTime_GetTime(&t_sleep);
+
+	/* Complete outstanding memory accesses, then sleep. WFI returns when an
+	 * interrupt is pending, although it is masked here. */
+	dsb();
+	wfi();
+
+	XTime_GetTime(&t_wake);
+	idle_n_sleeps++;
+	idle_sleep_time += (t_wake - t_sleep);
+
+	/* Only a tick already pending arrived while the core was asleep. If
+	 * another interrupt woke it, a tick that nests into that ISR finds the
+	 * core busy. */
+	if ((XScuGic_ReadReg(XPAR_PS7_SCUGIC_0_DIST_BASEADDR,
+				XSCUGIC_PEND_SET_OFFSET_CALC(IDLE_TICK_INTR_ID))
+			& (1U << (IDLE_TICK_INTR_ID % 32U))) == 0U)
+	{
+		idle_asleep = 0U;
+	}
+
+	/* The interrupt that woke the core is taken here */
+	Xil_ExceptionEnable();
+	idle_asleep = 0U;
+
+	return 1U;
+#else
+	return 0U;
+#endif
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		idleTickLatency()
+*
+* Description:	Records the latency of a TTC0 tick: in the WAKE statistics if
+* 				the core was asleep, otherwise in the BUSY statistics.
+*
+* param[in]		latency: TTC0 counts from the tick to the ISR.
+*
+* Returns:		None.
+*
+* Notes:		Called from the TTC0 ISR, on entry.
+*
+****************************************************************************/
+
+void idleTickLatency(uint32_t latency)
+{
+
+	seqlockWriteBegin(&IdleLatencyLock);
+
+	if (idle_lat_clear != 0U)
+	{
+		idle_lat_clear = 0U;
+		idleLatencyClear(&IdleWake);
+		idleLatencyClear(&IdleBusy);
+	}
+
+	if (idle_asleep != 0U)
+	{
+		idle_asleep = 0U;
+		idleLatencyAdd(&IdleWake, latency);
+	}
+	else
+	{
+		idleLatencyAdd(&IdleBusy, latency);
+	}
+
+	seqlockWriteEnd(&IdleLatencyLock);
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		idleStatsCmd()
+*
+* Description:	GET_IDLE_STATS: reads one of the idle statistics, or clears
+* 				them. Field 1 = selector (IDLE_STATS_xxx).
+*
+* Returns:		The selected value (WRITE_OKAY for IDLE_STATS_CLEAR), or
+* 				CMD_ERROR for an unknown selector. Latencies are in TTC0
+* 				counts, times in Global Timer counts; min and mean read 0 if
+* 				there are no samples.
+*
+* Notes:		The latency statistics are updated by the TTC0 ISR: they are
+* 				copied under a seqlock, with interrupts enabled. Clearing them
+* 				is left to the ISR, at the next tick.
+*
+****************************************************************************/
+
+uint32_t idleStatsCmd(uint32_t field1, uint32_t field2)
+{
+
+	uint32_t value = CMD_ERROR;
+	uint32_t seq;
+	idle_latency_t wake;
+	idle_latency_t busy;
+	XTime now;
+
+	XTime_GetTime(&now);
+
+	switch (field1)
+	{
+	case IDLE_STATS_SLEEPS:
+		return idle_n_sleeps;
+
+	case IDLE_STATS_SLEEP_TIME_LO:
+		return (uint32_t)idle_sleep_time;
+
+	case IDLE_STATS_SLEEP_TIME_HI:
+		return (uint32_t)(idle_sleep_time >> 32);
+
+	case IDLE_STATS_ELAPSED_LO:
+		return (uint32_t)(now - idle_t_clear);
+
+	case IDLE_STATS_ELAPSED_HI:
+		return (uint32_t)((now - idle_t_clear) >> 32);
+
+	case IDLE_STATS_CLEAR:
+		idle_n_sleeps = 0U;
+		idle_sleep_time = 0U;
+		idle_t_clear = now;
+		idle_lat_clear = 1U;
+		return WRITE_OKAY;
+
+	default:
+		break;
+	}
+
+	do
+	{
+		seq = seqlockReadBegin(&IdleLatencyLock);
+		wake = IdleWake;
+		busy = IdleBusy;
+	} while (seqlockReadRetry(&IdleLatencyLock, seq) != 0U);
+
+	if ((field1 >= IDLE_STATS_WAKE_N) && (field1 <= IDLE_STATS_WAKE_OVER))
+	{
+		value = idleLatencyRead(&wake, field1 - IDLE_STATS_WAKE_N);
+	}
+	else if ((field1 >= IDLE_STATS_BUSY_N) && (field1 <= IDLE_STATS_BUSY_OVER))
+	{
+		value = idleLatencyRead(&busy, field1 - IDLE_STATS_BUSY_N);
+	}
+
+	return value;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		idleLatencyAdd()
+*
+* Description:	Adds one latency to a set of statistics.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void idleLatencyAdd(idle_latency_t *p_lat, uint32_t latency)
+{
+
+	p_lat->n++;
+
+	if (latency < p_lat->min)
+	{
+		p_lat->min = latency;
+	}
+	if (latency > p_lat->max)
+	{
+		p_lat->max = latency;
+	}
+	p_lat->total += latency;
+
+	if (latency > IDLE_WAKE_BUDGET)
+	{
+		p_lat->over++;
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		idleLatencyClear()
+*
+* Description:	Clears a set of latency statistics.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void idleLatencyClear(idle_latency_t *p_lat)
+{
+
+	p_lat->n = 0U;
+	p_lat->min = 0xFFFFFFFFU;
+	p_lat->max = 0U;
+	p_lat->total = 0U;
+	p_lat->over = 0U;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		idleLatencyRead()
+*
+* Description:	Reads one value of a set of latency statistics.
+*
+* param[in]		selector: Offset from IDLE_STATS_WAKE_N (N, MIN, MAX, MEAN,
+* 				OVER).
+*
+* Returns:		The selected value.
+*
+****************************************************************************/
+
+uint32_t idleLatencyRead(const idle_latency_t *p_lat, uint32_t selector)
+{
+
+	switch (selector)
+	{
+	case (IDLE_STATS_WAKE_MIN - IDLE_STATS_WAKE_N):
+		return (p_lat->n == 0U) ? 0U : p_lat->min;
+
+	case (IDLE_STATS_WAKE_MAX - IDLE_STATS_WAKE_N):
+		return p_lat->max;
+
+	case (IDLE_STATS_WAKE_MEAN - IDLE_STATS_WAKE_N):
+		return (p_lat->n == 0U) ? 0U : (uint32_t)(p_lat->total / p_lat->n);
+
+	case (IDLE_STATS_WAKE_OVER - IDLE_STATS_WAKE_N):
+		return p_lat->over;
+
+	default:
+		return p_lat->n;
+	}
+
+}
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
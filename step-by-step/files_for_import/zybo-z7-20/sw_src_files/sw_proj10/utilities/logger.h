@@ -0,0 +1,166 @@
+/******************************************************************************
+ * @Title		:	Deferred Logger (Header File)
+ * @Filename	:	logger.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+#ifndef SRC_UTILITIES_LOGGER_H_
+#define SRC_UTILITIES_LOGGER_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#ifdef HOST_BUILD
+/* Host build (see concurrency.h): types and status codes only */
+#include "concurrency.h"
+#else
+/* Xilinx files */
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#endif
+
+/* Command handler (command registration, deferred responses) */
+#include "cmd_handler.h"
+
+/* Frame codec (FRAME_TAG_LOG) */
+#include "frame_codec.h"
+
+/* Message table */
+#include "log_messages.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* 1 = LOGx() calls write records; 0 = they compile to nothing */
+#define LOG_ENABLE					1
+
+/* Size of the log ring, in 32-bit words. Must be a power of 2. */
+#define LOG_RING_WORDS				4096U
+
+/* Largest number of words pushed to the host in one frame by logDrain() */
+#define LOG_DRAIN_MAX_WORDS			64U
+
+/* Arguments per record */
+#define LOG_MAX_ARGS				4U
+
+
+/* -------- Log record -------*/
+/*	LOGx() writes a record of 3 + N words to a RAM ring, with interrupts
+*	disabled for the few stores needed:
+*	-----------------------------------------------------------------
+*	| ID (2) | N | SEQ | TIME HI | TIME LO | ARG 0 | ... | ARG N-1 |
+*	-----------------------------------------------------------------
+*	ID = message ID (see log_messages.h). N = number of arguments.
+*	SEQ = records written or dropped, modulo 256; a gap means records were
+*	dropped because the ring was full.
+*	TIME = Global Timer count when the record was written (COUNTS_PER_SECOND).
+*
+*	logDrain() sends whole records from the main loop, packed into
+*	unsolicited frames with TAG = FRAME_TAG_LOG. All words are big-endian
+*	on the wire. The host decoder formats each record with the string from
+*	log_messages.h. Logging needs the framed protocol to reach the host; with
+*	the unframed protocol the ring can still be read with XSCT. */
+
+#define LOG_HEADER_WORDS			3U
+
+
+/* GET_LOG_STATS selectors (FIELD 1) */
+#define LOG_STATS_WRITTEN			0U
+#define LOG_STATS_DROPPED			1U
+#define LOG_STATS_PENDING			2U		// Words waiting to be sent
+#define LOG_STATS_CLEAR				3U
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* Message IDs, in log_messages.h order */
+#define LOG_ENUM_ENTRY(id, format)	id,
+
+typedef enum
+{
+	LOG_MESSAGES(LOG_ENUM_ENTRY)
+	LOG_N_MESSAGES
+} log_msg_t;
+
+/* Log ring */
+typedef struct {
+	volatile uint32_t wr;			// Words written (free-running)
+	volatile uint32_t rd;			// Words sent (free-running)
+	uint32_t seq;					// Records written or dropped
+} log_ring_t;
+
+/* Logger statistics */
+typedef struct {
+	volatile uint32_t n_written;	// Records written to the ring
+	volatile uint32_t n_dropped;	// Records lost: ring full
+} log_stats_t;
+
+
+/****************************************************************************/
+/***************** Macros (Inline Functions) Definitions ********************/
+/****************************************************************************/
+
+#if LOG_ENABLE
+#define LOG0(id)				logWrite((id), 0U, 0U, 0U, 0U, 0U)
+#define LOG1(id, a)				logWrite((id), 1U, (uint32_t)(a), 0U, 0U, 0U)
+#define LOG2(id, a, b)			logWrite((id), 2U, (uint32_t)(a), (uint32_t)(b), 0U, 0U)
+#define LOG3(id, a, b, c)		logWrite((id), 3U, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), 0U)
+#define LOG4(id, a, b, c, d)	logWrite((id), 4U, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d))
+#else
+#define LOG0(id)				((void)0)
+#define LOG1(id, a)				((void)0)
+#define LOG2(id, a, b)			((void)0)
+#define LOG3(id, a, b, c)		((void)0)
+#define LOG4(id, a, b, c, d)	((void)0)
+#endif
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Initialisation */
+int logRegisterCommands(void);
+
+/* Write a record; use the LOGx() macros */
+void logWrite(uint32_t id, uint32_t n_args, uint32_t arg0, uint32_t arg1,
+				uint32_t arg2, uint32_t arg3);
+
+/* Called from the main loop: sends pending records to the host */
+void logDrain(void);
+
+
+#endif /* SRC_UTILITIES_LOGGER_H_ */
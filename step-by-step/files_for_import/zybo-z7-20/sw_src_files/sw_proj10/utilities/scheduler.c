@@ -0,0 +1,872 @@
+/******************************************************************************
+ * @Title		:	Time-Triggered Scheduler
+ * @Filename	:	scheduler.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include "scheduler.h"
+
+/* Critical sections (clearing the counters of a preemptive task) */
+#include "../intr_sys.h"
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* Tasks, in dispatch (priority) order */
+static sched_entry_t	SchedTable[SCHED_MAX_TASKS];
+static uint32_t			sched_n_tasks;
+
+/* Preemptive tasks (SCHED_PREEMPT), released by the TTC0 ISR */
+static sched_entry_t	*SchedPreempt[SCHED_MAX_TASKS];
+static uint32_t			sched_n_preempt;
+
+/* Ticks counted by the ISR, and ticks dispatched by the main loop */
+static uint32_t volatile sched_ticks;
+static uint32_t			sched_ticks_done;
+
+/* Largest number of ticks the main loop has been behind */
+static uint32_t			sched_max_backlog;
+
+/* Global Timer count at the last SCHED_TICK_HISTORY ticks */
+static XTime			sched_tick_time[SCHED_TICK_HISTORY];
+
+/* Late start / overrun alarm handler (SCHED_ALARM tasks) */
+static sched_alarm_t	p_SchedAlarm = NULL;
+
+
+
+/****************************************************************************/
+/************************** Function Prototypes *****************************/
+/****************************************************************************/
+
+/* Command handlers */
+static uint32_t schedProfileCmd(uint32_t field1, uint32_t field2);
+
+/* Functions internal to this file */
+static void schedEvent(sched_entry_t *p_entry, uint32_t event, uint32_t ticks);
+static void schedRun(sched_entry_t *p_entry, uint32_t tick);
+static void schedEntryClear(sched_entry_t *p_entry);
+#if SCHED_PROFILE
+static void schedProfileRun(sched_profile_t *p_prof, uint32_t start_valid,
+								uint32_t start, uint32_t exec);
+static void schedProfileClear(sched_profile_t *p_prof);
+static uint32_t schedHistBin(uint32_t value);
+#endif
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		schedInit()
+*
+* Description:	Checks the task table, and builds the dispatch list in
+* 				priority order (table order for equal priorities).
+*
+* param[in]		*p_table: Task table (must stay valid: it is not copied).
+* param[in]		n_tasks: Number of entries.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if there are too many tasks, or
+* 				an entry has no function, a period of 0, an offset not
+* 				below its period, or is SCHED_PREEMPT with a priority of
+* 				SCHED_SGI_LEVELS or more.
+*
+* Notes:		Must be called before TTC0 is started.
+*
+****************************************************************************/
+
+int schedInit(const sched_task_t *p_table, uint32_t n_tasks)
+{
+
+	uint32_t idx;
+	uint32_t pos;
+
+	sched_n_tasks = 0U;
+	sched_n_preempt = 0U;
+	sched_ticks = 0U;
+	sched_ticks_done = 0U;
+	sched_max_backlog = 0U;
+
+	if (n_tasks > SCHED_MAX_TASKS)
+	{
+		return XST_FAILURE;
+	}
+
+	for (idx = 0; idx < n_tasks; idx++)
+	{
+		if ( (p_table[idx].func == NULL) || (p_table[idx].period == 0U)
+				|| (p_table[idx].offset >= p_table[idx].period)
+				|| ( ((p_table[idx].policy & SCHED_PREEMPT) != 0U)
+						&& (p_table[idx].priority >= SCHED_SGI_LEVELS) ) )
+		{
+			sched_n_tasks = 0U;
+			return XST_FAILURE;
+		}
+
+		/* Insert after every task of higher or equal priority */
+		pos = sched_n_tasks;
+		while ( (pos > 0U) && (SchedTable[pos - 1U].p_task->priority > p_table[idx].priority) )
+		{
+			SchedTable[pos] = SchedTable[pos - 1U];
+			pos--;
+		}
+
+		SchedTable[pos].p_task = &p_table[idx];
+		SchedTable[pos].id = idx;
+		SchedTable[pos].countdown = p_table[idx].offset + 1U;
+		SchedTable[pos].released = 0U;
+		SchedTable[pos].started = 0U;
+		seqlockInit(&SchedTable[pos].release_lock);
+#if SCHED_PROFILE
+		seqlockInit(&SchedTable[pos].profile_lock);
+#endif
+		schedEntryClear(&SchedTable[pos]);
+		sched_n_tasks++;
+	}
+
+	/* Preemptive tasks, released by the TTC0 ISR, in priority order */
+	for (idx = 0; idx < sched_n_tasks; idx++)
+	{
+		if ((SchedTable[idx].p_task->policy & SCHED_PREEMPT) != 0U)
+		{
+			SchedPreempt[sched_n_preempt] = &SchedTable[idx];
+			sched_n_preempt++;
+		}
+	}
+
+	return XST_SUCCESS;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedRegisterCommands()
+*
+* Description:	Registers GET_TASK_PROFILE with the command handler.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if registration failed.
+*
+* Notes:		cmdHandlerInit() must be called first.
+*
+****************************************************************************/
+
+int schedRegisterCommands(void)
+{
+	return registerCommand(GET_TASK_PROFILE, schedProfileCmd);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedSetAlarm()
+*
+* Description:	Sets the handler called on late starts and overruns of tasks
+* 				with the SCHED_ALARM policy (e.g. to raise a GPIO).
+*
+* Returns:		None.
+*
+* Notes:		The handler is called from the main loop, between tasks.
+*
+****************************************************************************/
+
+void schedSetAlarm(sched_alarm_t alarm)
+{
+	p_SchedAlarm = alarm;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedTick()
+*
+* Description:	Timestamps and counts a scheduler tick, and releases the
+* 				preemptive tasks that are due: each is counted, and the SGI
+* 				of its level is pended.
+*
+* Returns:		None.
+*
+* Notes:		Called from the TTC0 ISR. Tasks are not run here, so the ISR
+* 				does not change when tasks are added.
+*
+****************************************************************************/
+
+void schedTick(void)
+{
+
+	uint32_t idx;
+	uint32_t level;
+	uint32_t levels = 0U;
+	sched_entry_t *p_entry;
+
+	XTime_GetTime(&sched_tick_time[sched_ticks & (SCHED_TICK_HISTORY - 1U)]);
+
+	for (idx = 0; idx < sched_n_preempt; idx++)
+	{
+		p_entry = SchedPreempt[idx];
+
+		p_entry->countdown--;
+		if (p_entry->countdown == 0U)
+		{
+			p_entry->countdown = p_entry->p_task->period;
+			seqlockWriteBegin(&p_entry->release_lock);
+			p_entry->release_tick = sched_ticks;
+			p_entry->released++;
+			seqlockWriteEnd(&p_entry->release_lock);
+			levels |= (1U << p_entry->p_task->priority);
+		}
+	}
+
+	sched_ticks++;
+
+	/* Pend the SGI of each level with a task released */
+	for (level = 0; levels != 0U; level++)
+	{
+		if ((levels & (1U << level)) != 0U)
+		{
+			XScuGic_WriteReg(XPAR_PS7_SCUGIC_0_DIST_BASEADDR, XSCUGIC_SFI_TRIG_OFFSET,
+								SCHED_SGI_TO_SELF | (SCHED_SGI_BASE + level));
+			levels &= ~(1U << level);
+		}
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedSgiHandler()
+*
+* Description:	Runs the released preemptive tasks of one level, in priority
+* 				(table) order, until none is left. A release that comes
+* 				while the task is pending or running is run next.
+*
+* param[in]		CallBackRef: Level (task priority) of the SGI.
+*
+* Returns:		None.
+*
+* Notes:		Handler of the SGI of each level (connected by
+* 				addSchedToInterruptSystem()). Runs with nested interrupts
+* 				enabled, so that the tasks can be preempted by higher levels
+* 				(see scheduler.h).
+*
+****************************************************************************/
+
+void schedSgiHandler(void *CallBackRef)
+{
+
+	uint32_t level = (uint32_t)CallBackRef;
+	uint32_t idx;
+	uint32_t released;
+	uint32_t tick;
+	uint32_t seq;
+	uint32_t pending;
+	uint32_t ran;
+	sched_entry_t *p_entry;
+
+	/* === ENABLE NESTED INTERRUPTS! === */
+	Xil_EnableNestedInterrupts();
+
+	do
+	{
+		ran = 0U;
+
+		for (idx = 0; idx < sched_n_preempt; idx++)
+		{
+			p_entry = SchedPreempt[idx];
+			if (p_entry->p_task->priority != level)
+			{
+				continue;
+			}
+
+			/* Releases and tick of the last release, as one (TTC0 ISR) */
+			do
+			{
+				seq = seqlockReadBegin(&p_entry->release_lock);
+				released = p_entry->released;
+				tick = p_entry->release_tick;
+			} while (seqlockReadRetry(&p_entry->release_lock, seq) != 0U);
+
+			pending = released - p_entry->started;
+			if (pending == 0U)
+			{
+				continue;
+			}
+
+			/* Late start: the next release has already been counted */
+			if (pending > 1U)
+			{
+				p_entry->n_late++;
+				schedEvent(p_entry, SCHED_EVENT_LATE, (pending - 1U) * p_entry->p_task->period);
+
+				if ((p_entry->p_task->policy & SCHED_SKIP) != 0U)
+				{
+					p_entry->n_skipped += (pending - 1U);
+					p_entry->started += (pending - 1U);
+				}
+			}
+
+			/* Run the oldest release not yet run */
+			p_entry->started++;
+			tick -= (released - p_entry->started) * p_entry->p_task->period;
+			schedRun(p_entry, tick);
+			ran = 1U;
+
+			/* Overrun: released again before the task returned */
+			if (p_entry->released != p_entry->started)
+			{
+				p_entry->n_overruns++;
+				schedEvent(p_entry, SCHED_EVENT_OVERRUN,
+							(p_entry->released - p_entry->started) * p_entry->p_task->period);
+			}
+		}
+	} while (ran != 0U);
+
+	/* === DISABLE NESTED INTERRUPTS! === */
+	Xil_DisableNestedInterrupts();
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedDispatch()
+*
+* Description:	If a tick has been counted that has not been dispatched yet,
+* 				runs every task due in that tick, in priority order.
+*
+* Returns:		1 if a tick was dispatched, 0 if there was nothing to do (the
+* 				main loop can then do background work).
+*
+* Notes:		Called from the main loop. Tasks run to completion. If the
+* 				tasks of one tick take longer than a tick, the following ticks
+* 				are dispatched late, one per call. SCHED_PREEMPT tasks are
+* 				not run here (see schedSgiHandler()). A run dispatched or
+* 				returning after the next release of its task is counted and
+* 				handled by the task's policy (see scheduler.h).
+* 				With SCHED_PROFILE, each run is timed.
+*
+****************************************************************************/
+
+uint32_t schedDispatch(void)
+{
+
+	uint32_t idx;
+	uint32_t tick;
+	uint32_t period;
+	sched_entry_t *p_entry;
+
+	if (sched_ticks == sched_ticks_done)
+	{
+		return 0U;
+	}
+
+	tick = sched_ticks_done;
+	if ((sched_ticks - 1U - tick) > sched_max_backlog)
+	{
+		sched_max_backlog = sched_ticks - 1U - tick;
+	}
+	sched_ticks_done++;
+
+	for (idx = 0; idx < sched_n_tasks; idx++)
+	{
+		p_entry = &SchedTable[idx];
+
+		/* Released by the TTC0 ISR, run by its SGI handler */
+		if ((p_entry->p_task->policy & SCHED_PREEMPT) != 0U)
+		{
+			continue;
+		}
+
+		p_entry->countdown--;
+		if (p_entry->countdown == 0U)
+		{
+			period = p_entry->p_task->period;
+			p_entry->countdown = period;
+
+			/* Late start: the next release has already been counted */
+			if ((sched_ticks - 1U - tick) >= period)
+			{
+				p_entry->n_late++;
+				schedEvent(p_entry, SCHED_EVENT_LATE, sched_ticks - 1U - tick);
+
+				if ((p_entry->p_task->policy & SCHED_SKIP) != 0U)
+				{
+					p_entry->n_skipped++;
+					continue;
+				}
+			}
+
+			schedRun(p_entry, tick);
+
+			/* Overrun: the task returned after its next release */
+			if ((sched_ticks - 1U - tick) >= period)
+			{
+				p_entry->n_overruns++;
+				schedEvent(p_entry, SCHED_EVENT_OVERRUN, sched_ticks - 1U - tick);
+			}
+		}
+	}
+
+	return 1U;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedPending()
+*
+* Description:	Checks for ticks counted that have not been dispatched yet.
+*
+* Returns:		1 if schedDispatch() has work to do, otherwise 0.
+*
+****************************************************************************/
+
+uint32_t schedPending(void)
+{
+	return (sched_ticks != sched_ticks_done) ? 1U : 0U;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedGetTicks()
+*
+* Description:	Returns the number of ticks counted since TTC0 was started.
+*
+* Returns:		Tick count (wraps at 2^32).
+*
+****************************************************************************/
+
+uint32_t schedGetTicks(void)
+{
+	return sched_ticks;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedProfileCmd()
+*
+* Description:	GET_TASK_PROFILE: reads one value of a task profile, or clears
+* 				it. Field 1 = task ID (SCHED_ALL with SCHED_PROF_CLEAR);
+* 				Field 2 = selector (SCHED_PROF_xxx).
+*
+* Returns:		The selected value (WRITE_OKAY for SCHED_PROF_CLEAR), or
+* 				CMD_ERROR for an unknown task or selector. Times are in Global
+* 				Timer counts; min and mean read 0 if there is no sample.
+*
+* Notes:		Clearing all profiles also resets the worst-case backlog, and
+* 				clears the alarm (SCHED_EVENT_CLEAR).
+*
+****************************************************************************/
+
+uint32_t schedProfileCmd(uint32_t field1, uint32_t field2)
+{
+
+	uint32_t idx;
+	sched_entry_t *p_entry = NULL;
+#if SCHED_PROFILE
+	uint32_t bin = field2 & 0xFFU;
+	uint32_t seq;
+	sched_profile_t prof;
+	sched_profile_t *p_prof = &prof;
+#endif
+
+	if ( (field1 == SCHED_ALL) && (field2 == SCHED_PROF_CLEAR) )
+	{
+		for (idx = 0; idx < sched_n_tasks; idx++)
+		{
+			schedEntryClear(&SchedTable[idx]);
+		}
+		sched_max_backlog = 0U;
+
+		if (p_SchedAlarm != NULL)
+		{
+			p_SchedAlarm(SCHED_ALL, SCHED_EVENT_CLEAR);
+		}
+		return WRITE_OKAY;
+	}
+
+	for (idx = 0; idx < sched_n_tasks; idx++)
+	{
+		if (SchedTable[idx].id == field1)
+		{
+			p_entry = &SchedTable[idx];
+			break;
+		}
+	}
+
+	if (p_entry == NULL)
+	{
+		return CMD_ERROR;
+	}
+
+	switch (field2)
+	{
+	case SCHED_PROF_LATE:
+		return p_entry->n_late;
+
+	case SCHED_PROF_OVERRUNS:
+		return p_entry->n_overruns;
+
+	case SCHED_PROF_SKIPPED:
+		return p_entry->n_skipped;
+
+	case SCHED_PROF_MAX_BACKLOG:
+		return sched_max_backlog;
+
+	case SCHED_PROF_FUNC:
+		return (uint32_t)p_entry->p_task->func;
+
+	case SCHED_PROF_CLEAR:
+		schedEntryClear(p_entry);
+		return WRITE_OKAY;
+
+	default:
+		break;
+	}
+
+#if SCHED_PROFILE
+	/* Copy the profile as one: a preemptive task may be adding a run */
+	do
+	{
+		seq = seqlockReadBegin(&p_entry->profile_lock);
+		prof = p_entry->profile;
+	} while (seqlockReadRetry(&p_entry->profile_lock, seq) != 0U);
+
+	switch (field2)
+	{
+	case SCHED_PROF_RUNS:
+		return p_prof->n_runs;
+
+	case SCHED_PROF_EXEC_MIN:
+		return (p_prof->n_runs == 0U) ? 0U : p_prof->exec_min;
+
+	case SCHED_PROF_EXEC_MAX:
+		return p_prof->exec_max;
+
+	case SCHED_PROF_EXEC_MEAN:
+		return (p_prof->n_runs == 0U) ? 0U : (uint32_t)(p_prof->exec_total / p_prof->n_runs);
+
+	case SCHED_PROF_START_MIN:
+		return (p_prof->n_runs == p_prof->start_lost) ? 0U : p_prof->start_min;
+
+	case SCHED_PROF_START_MAX:
+		return p_prof->start_max;
+
+	case SCHED_PROF_START_MEAN:
+		return (p_prof->n_runs == p_prof->start_lost) ? 0U
+				: (uint32_t)(p_prof->start_total / (p_prof->n_runs - p_prof->start_lost));
+
+	case SCHED_PROF_START_LOST:
+		return p_prof->start_lost;
+
+	default:
+		break;
+	}
+
+	if (bin < SCHED_HIST_BINS)
+	{
+		if ((field2 & ~0xFFU) == SCHED_PROF_EXEC_HIST)
+		{
+			return p_prof->exec_hist[bin];
+		}
+		if ((field2 & ~0xFFU) == SCHED_PROF_START_HIST)
+		{
+			return p_prof->start_hist[bin];
+		}
+	}
+#endif
+
+	return CMD_ERROR;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedEvent()
+*
+* Description:	Logs a late start or an overrun, and calls the alarm handler
+* 				if the task has the SCHED_ALARM policy.
+*
+* param[in]		*p_entry: The task.
+* param[in]		event: SCHED_EVENT_LATE or SCHED_EVENT_OVERRUN.
+* param[in]		ticks: Ticks counted since the release of the run.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void schedEvent(sched_entry_t *p_entry, uint32_t event, uint32_t ticks)
+{
+
+	if (event == SCHED_EVENT_LATE)
+	{
+		LOG2(LOG_SCHED_LATE, p_entry->id, ticks);
+	}
+	else
+	{
+		LOG2(LOG_SCHED_OVERRUN, p_entry->id, ticks);
+	}
+
+	if ( ((p_entry->p_task->policy & SCHED_ALARM) != 0U) && (p_SchedAlarm != NULL) )
+	{
+		p_SchedAlarm(p_entry->id, event);
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedRun()
+*
+* Description:	Runs a task; with SCHED_PROFILE, times the run.
+*
+* param[in]		*p_entry: The task.
+* param[in]		tick: Tick of the release being run (for the start jitter).
+*
+* Returns:		None.
+*
+* Notes:		The execution time of a preemptive task includes the time it
+* 				was preempted.
+*
+****************************************************************************/
+
+void schedRun(sched_entry_t *p_entry, uint32_t tick)
+{
+
+#if SCHED_PROFILE
+	XTime t_start;
+	XTime t_end;
+	XTime t_tick;
+	uint32_t start_valid;
+
+	/* The slot still holds this tick if the ISR has not counted
+	 * SCHED_TICK_HISTORY ticks since: checked after the read, so a slot
+	 * overwritten meanwhile is not used either. sched_tick_time is not
+	 * volatile: the barrier keeps the read before the check. */
+	t_tick = sched_tick_time[tick & (SCHED_TICK_HISTORY - 1U)];
+	CONC_DMB();
+	start_valid = ((sched_ticks - tick) <= SCHED_TICK_HISTORY) ? 1U : 0U;
+
+	XTime_GetTime(&t_start);
+	p_entry->p_task->func();
+	XTime_GetTime(&t_end);
+	seqlockWriteBegin(&p_entry->profile_lock);
+	schedProfileRun(&p_entry->profile, start_valid, (uint32_t)(t_start - t_tick),
+						(uint32_t)(t_end - t_start));
+	seqlockWriteEnd(&p_entry->profile_lock);
+#else
+	p_entry->p_task->func();
+#endif
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedEntryClear()
+*
+* Description:	Clears the overrun counters and the profile of a task.
+*
+* Returns:		None.
+*
+* Notes:		Called from the main loop. The SGI handler of a preemptive
+* 				task also writes them: its level is held off meanwhile, so
+* 				that there is one writer at a time.
+*
+****************************************************************************/
+
+void schedEntryClear(sched_entry_t *p_entry)
+{
+
+	uint32_t preempt = p_entry->p_task->policy & SCHED_PREEMPT;
+	uint32_t saved_mask = 0U;
+
+	if (preempt != 0U)
+	{
+		saved_mask = enterCritical(SCHED_SGI_PRI(p_entry->p_task->priority));
+	}
+
+	p_entry->n_late = 0U;
+	p_entry->n_overruns = 0U;
+	p_entry->n_skipped = 0U;
+#if SCHED_PROFILE
+	seqlockWriteBegin(&p_entry->profile_lock);
+	schedProfileClear(&p_entry->profile);
+	seqlockWriteEnd(&p_entry->profile_lock);
+#endif
+
+	if (preempt != 0U)
+	{
+		exitCritical(saved_mask);
+	}
+
+}
+
+
+
+#if SCHED_PROFILE
+
+
+/******************************************************************************
+*
+* Function:		schedProfileRun()
+*
+* Description:	Adds one task run to a profile.
+*
+* param[in]		*p_prof: The task profile.
+* param[in]		start_valid: 0 if the tick timestamp was no longer kept: the
+* 				run is counted in start_lost, and start is not used.
+* param[in]		start: Start jitter (tick to task start), Global Timer counts.
+* param[in]		exec: Execution time, Global Timer counts.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void schedProfileRun(sched_profile_t *p_prof, uint32_t start_valid,
+						uint32_t start, uint32_t exec)
+{
+
+	p_prof->n_runs++;
+
+	if (exec < p_prof->exec_min)
+	{
+		p_prof->exec_min = exec;
+	}
+	if (exec > p_prof->exec_max)
+	{
+		p_prof->exec_max = exec;
+	}
+	p_prof->exec_total += exec;
+	p_prof->exec_hist[schedHistBin(exec)]++;
+
+	if (start_valid == 0U)
+	{
+		p_prof->start_lost++;
+		return;
+	}
+
+	if (start < p_prof->start_min)
+	{
+		p_prof->start_min = start;
+	}
+	if (start > p_prof->start_max)
+	{
+		p_prof->start_max = start;
+	}
+	p_prof->start_total += start;
+	p_prof->start_hist[schedHistBin(start)]++;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedProfileClear()
+*
+* Description:	Clears a task profile.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void schedProfileClear(sched_profile_t *p_prof)
+{
+
+	uint32_t bin;
+
+	p_prof->n_runs = 0U;
+	p_prof->exec_min = 0xFFFFFFFFU;
+	p_prof->exec_max = 0U;
+	p_prof->exec_total = 0U;
+	p_prof->start_min = 0xFFFFFFFFU;
+	p_prof->start_max = 0U;
+	p_prof->start_total = 0U;
+	p_prof->start_lost = 0U;
+
+	for (bin = 0; bin < SCHED_HIST_BINS; bin++)
+	{
+		p_prof->exec_hist[bin] = 0U;
+		p_prof->start_hist[bin] = 0U;
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		schedHistBin()
+*
+* Description:	Returns the histogram bin of a time: its number of significant
+* 				bits (0 for 0, 1 for 1, 2 for 2..3, ..., 32).
+*
+* Returns:		Bin number, 0 to SCHED_HIST_BINS - 1.
+*
+****************************************************************************/
+
+uint32_t schedHistBin(uint32_t value)
+{
+	return (value == 0U) ? 0U : (32U - (uint32_t)__builtin_clz(value));
+}
+#endif
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
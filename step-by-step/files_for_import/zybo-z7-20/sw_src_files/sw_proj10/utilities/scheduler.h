@@ -0,0 +1,265 @@
+/******************************************************************************
+ * @Title		:	Time-Triggered Scheduler (Header File)
+ * @Filename	:	scheduler.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+#ifndef SRC_UTILITIES_SCHEDULER_H_
+#define SRC_UTILITIES_SCHEDULER_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+/* Xilinx files */
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "xparameters.h"
+#include "xscugic.h"
+#include "xil_exception.h"
+
+/* Command handler (command registration) */
+#include "cmd_handler.h"
+
+/* Deferred logger (late starts, overruns) */
+#include "logger.h"
+
+/* Seqlock (release counts and profiles, read without masking interrupts) */
+#include "concurrency.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* Largest number of tasks in the task table */
+#define SCHED_MAX_TASKS				16U
+
+/* 1 = profile each task run (see below); 0 = no profiling */
+#define SCHED_PROFILE				1
+
+/* Tick timestamps kept for the start jitter. Must be a power of 2. */
+#define SCHED_TICK_HISTORY			16U
+
+/* Histogram bins: bin n counts times of n significant bits, i.e. in the
+ * range [2^(n-1), 2^n) counts (bin 0 counts zero). */
+#define SCHED_HIST_BINS				33U
+
+
+/* -------- Task table -------*/
+/*	The application declares its tasks in a table (see tasks.c) and passes
+*	it to schedInit(). Each entry gives:
+*	  - the task function (void f(void), runs to completion),
+*	  - the period, in ticks (TTC0 cycles, >= 1),
+*	  - the offset of the first run, in ticks (< period), used to spread
+*	    tasks with the same period over different ticks,
+*	  - the priority (0 = highest): tasks due in the same tick are run in
+*	    priority order. Tasks with equal priority run in table order,
+*	  - the overrun policy (see below).
+*
+*	The TTC0 ISR only counts ticks (schedTick()). The main loop calls
+*	schedDispatch(), which runs the tasks due in each tick counted. Adding
+*	a task only needs a new table entry. */
+
+
+/* -------- Preemptive tasks -------*/
+/*	A task with the SCHED_PREEMPT policy does not run in the main loop: it
+*	runs in the handler of a GIC software-generated interrupt (SGI), one SGI
+*	per priority level (task priority 0 to SCHED_SGI_LEVELS - 1). When the
+*	task is due, the TTC0 ISR releases it and pends the SGI of its level;
+*	the SGI handler runs the released tasks of that level, in table order.
+*
+*	The SGI handlers run with nested interrupts enabled, and the binary
+*	point (see xScuGicInit()) makes every priority bit a preemption bit. So
+*	the GIC preempts a running task as soon as a task of higher priority
+*	(or TTC0, UART1) is pending, and resumes it afterwards, on the same
+*	stack: no RTOS and no context switch code. Tasks of the same level run
+*	to completion, one after the other. Every preemptive task preempts the
+*	main loop (commands, the other tasks).
+*
+*	A preemptive task is released again while it is still pending or
+*	running: the release is counted (see Overruns, below), and it runs
+*	after the current run. Data shared with code at another priority must
+*	be protected (e.g. with enterCritical(), see intr_sys.h). The release
+*	count and tick, and the task profiles, are read under a seqlock (see
+*	concurrency.h), so the scheduler itself masks no interrupts. */
+
+#define SCHED_SGI_LEVELS			6U
+#define SCHED_SGI_BASE				0U		// SGI ID of level 0 (SGIs 0 - 5)
+
+/* GIC priority of each level: below TTC0 (0xA0) and UART1 (0xB0), one
+ * implemented priority step (0x08) apart, and above the priority mask
+ * (0xF0). */
+#define SCHED_SGI_PRI_BASE			0xC0U
+#define SCHED_SGI_PRI_STEP			0x08U
+#define SCHED_SGI_PRI(level)		(SCHED_SGI_PRI_BASE + ((level) * SCHED_SGI_PRI_STEP))
+
+/* Software Generated Interrupt register: send to the requesting CPU only */
+#define SCHED_SGI_TO_SELF			0x02000000U
+
+
+/* -------- Overruns -------*/
+/*	The deadline of each run is the next release of the task (one period
+*	after the tick it was released in). The scheduler counts, per task:
+*	  - late starts: the run was dispatched after its deadline, because the
+*	    main loop had fallen behind the ticks (SCHED_PREEMPT: because work of
+*	    the same or higher priority ran);
+*	  - overruns: the run returned after its deadline.
+*	Each event is logged (see logger.h). The policy of the task sets what
+*	happens to a late run:
+*	  SCHED_CATCH_UP: it is run anyway, so every release is run (late).
+*	  SCHED_SKIP:     it is skipped and counted; only the latest release is
+*	                  run once the main loop has caught up.
+*	Either can be combined with SCHED_ALARM, which calls the alarm handler
+*	(see schedSetAlarm()) on every late start or overrun of the task. */
+
+#define SCHED_CATCH_UP				0x00U
+#define SCHED_SKIP					0x01U
+#define SCHED_ALARM					0x10U
+#define SCHED_PREEMPT				0x20U	// See Preemptive tasks, above
+
+/* Alarm handler events */
+#define SCHED_EVENT_CLEAR			0U		// Alarms cleared by the host
+#define SCHED_EVENT_LATE			1U
+#define SCHED_EVENT_OVERRUN			2U
+
+
+/* -------- Task profiles -------*/
+/*	Each task run is timed with the Global Timer (COUNTS_PER_SECOND):
+*	  - execution time: from the call of the task function to its return;
+*	  - start jitter: from the TTC0 tick (timestamped in the ISR) to the
+*	    call of the task function. It includes the ISR exit, the tasks of
+*	    higher priority run before it in the same tick, and any delay of the
+*	    main loop (a command being executed, a late tick).
+*	For each, the min, max, mean and a log2 histogram are kept per task.
+*	The tick timestamps of the last SCHED_TICK_HISTORY ticks are kept: a run
+*	started more ticks than that after its release (an overloaded main loop)
+*	has no start jitter sample. It is counted (SCHED_PROF_START_LOST) and
+*	left out of the start statistics, rather than measured against the
+*	timestamp of a later tick.
+*
+*	GET_TASK_PROFILE: Field 1 = task ID (index in the task table),
+*	Field 2 = selector (SCHED_PROF_xxx; for the histograms, add the bin
+*	number to SCHED_PROF_EXEC_HIST or SCHED_PROF_START_HIST). The overrun
+*	counters can be read when SCHED_PROFILE is 0; the other values cannot. */
+
+#define SCHED_PROF_RUNS				0U
+#define SCHED_PROF_EXEC_MIN			1U
+#define SCHED_PROF_EXEC_MAX			2U
+#define SCHED_PROF_EXEC_MEAN		3U
+#define SCHED_PROF_START_MIN		4U
+#define SCHED_PROF_START_MAX		5U
+#define SCHED_PROF_START_MEAN		6U
+#define SCHED_PROF_FUNC				7U		// Task function address
+#define SCHED_PROF_CLEAR			8U		// Field 1 = SCHED_ALL: all tasks, and alarms
+#define SCHED_PROF_LATE				9U
+#define SCHED_PROF_OVERRUNS			10U
+#define SCHED_PROF_SKIPPED			11U
+#define SCHED_PROF_MAX_BACKLOG		12U		// Any task ID: ticks behind, worst case
+#define SCHED_PROF_START_LOST		13U		// Runs with no start jitter sample
+#define SCHED_PROF_EXEC_HIST		0x100U
+#define SCHED_PROF_START_HIST		0x200U
+
+#define SCHED_ALL					0xFFFFFFFFU
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+typedef void (*sched_func_t)(void);
+
+/* Task table entry */
+typedef struct {
+	sched_func_t func;
+	uint32_t period;			// Ticks between runs (>= 1)
+	uint32_t offset;			// Tick of the first run (< period)
+	uint32_t priority;			// 0 = highest
+	uint32_t policy;			// SCHED_CATCH_UP or SCHED_SKIP, | SCHED_ALARM, SCHED_PREEMPT
+} sched_task_t;
+
+/* Called on late starts and overruns of SCHED_ALARM tasks, and when the
+ * host clears the profiles (id = SCHED_ALL, event = SCHED_EVENT_CLEAR) */
+typedef void (*sched_alarm_t)(uint32_t id, uint32_t event);
+
+/* Execution time and start jitter statistics of a task (Global Timer counts) */
+typedef struct {
+	uint32_t n_runs;
+	uint32_t exec_min;
+	uint32_t exec_max;
+	uint64_t exec_total;
+	uint32_t start_min;
+	uint32_t start_max;
+	uint64_t start_total;
+	uint32_t start_lost;		// Runs started over SCHED_TICK_HISTORY ticks late
+	uint32_t exec_hist[SCHED_HIST_BINS];
+	uint32_t start_hist[SCHED_HIST_BINS];
+} sched_profile_t;
+
+/* Run-time state of a task */
+typedef struct {
+	const sched_task_t *p_task;
+	uint32_t id;				// Index in the task table
+	uint32_t countdown;			// Ticks to the next run
+	uint32_t n_late;			// Runs dispatched after their deadline
+	uint32_t n_overruns;		// Runs that returned after their deadline
+	uint32_t n_skipped;			// Late runs skipped (SCHED_SKIP)
+	volatile uint32_t released;	// SCHED_PREEMPT: releases (TTC0 ISR)...
+	uint32_t started;			// ...and runs started (SGI handler)
+	volatile uint32_t release_tick;	// SCHED_PREEMPT: tick of the last release
+	seqlock_t release_lock;		// released and release_tick, as one
+#if SCHED_PROFILE
+	sched_profile_t profile;
+	seqlock_t profile_lock;		// Written where the task runs, read by commands
+#endif
+} sched_entry_t;
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Initialisation */
+int schedInit(const sched_task_t *p_table, uint32_t n_tasks);
+int schedRegisterCommands(void);
+void schedSetAlarm(sched_alarm_t alarm);
+
+/* Called from the TTC0 ISR, once per tick */
+void schedTick(void);
+
+/* SGI handler of the preemptive tasks (CallBackRef = level) */
+void schedSgiHandler(void *CallBackRef);
+
+/* Called from the main loop */
+uint32_t schedDispatch(void);
+uint32_t schedPending(void);
+uint32_t schedGetTicks(void);
+
+
+#endif /* SRC_UTILITIES_SCHEDULER_H_ */
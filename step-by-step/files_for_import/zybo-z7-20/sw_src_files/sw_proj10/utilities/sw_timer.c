@@ -0,0 +1,363 @@
+/******************************************************************************
+ * @Title		:	Software Timers
+ * @Filename	:	sw_timer.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include "sw_timer.h"
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* Timer wheel: a list of timers per slot */
+static sw_timer_t		*SwTimerWheel[SW_TIMER_LEVELS][SW_TIMER_SLOTS];
+
+/* Next tick to be processed by swTimerTick() */
+static uint32_t			sw_timer_now = 0U;
+
+
+
+/****************************************************************************/
+/************************** Function Prototypes *****************************/
+/****************************************************************************/
+
+/* Functions internal to this file */
+static void swTimerLink(sw_timer_t *p_timer);
+static void swTimerUnlink(sw_timer_t *p_timer);
+static uint32_t swTimerCascade(uint32_t level, uint32_t slot);
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerInit()
+*
+* Description:	Sets up a timer (stopped).
+*
+* param[in]		*p_timer: The timer.
+* param[in]		func: Called when the timer expires.
+* param[in]		p_arg: Passed to func.
+*
+* Returns:		None.
+*
+* Notes:		Must not be called on a running timer.
+*
+****************************************************************************/
+
+void swTimerInit(sw_timer_t *p_timer, sw_timer_func_t func, void *p_arg)
+{
+	p_timer->next = NULL;
+	p_timer->pprev = NULL;
+	p_timer->expires = 0U;
+	p_timer->period = 0U;
+	p_timer->func = func;
+	p_timer->p_arg = p_arg;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerStart()
+*
+* Description:	Starts (or restarts) a timer.
+*
+* param[in]		*p_timer: The timer (set up with swTimerInit()).
+* param[in]		ticks: Ticks to the first expiry (1 = next tick).
+* param[in]		period: Ticks between later expiries; 0 = one-shot.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if the timer has no callback, or
+* 				ticks or period is out of range (ticks 1 to
+* 				SW_TIMER_MAX_TICKS, period up to SW_TIMER_MAX_TICKS).
+*
+* Notes:		Periodic timers are reloaded from their expiry tick, so they
+* 				do not drift, however late their callbacks run.
+*
+****************************************************************************/
+
+int swTimerStart(sw_timer_t *p_timer, uint32_t ticks, uint32_t period)
+{
+
+	if ( (p_timer->func == NULL) || (ticks == 0U)
+			|| (ticks > SW_TIMER_MAX_TICKS) || (period > SW_TIMER_MAX_TICKS) )
+	{
+		return XST_FAILURE;
+	}
+
+	swTimerUnlink(p_timer);
+
+	/* sw_timer_now is the next tick processed, so ticks = 1 expires then */
+	p_timer->expires = sw_timer_now + ticks - 1U;
+	p_timer->period = period;
+	swTimerLink(p_timer);
+
+	return XST_SUCCESS;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerStop()
+*
+* Description:	Stops a timer. Does nothing if it is not running.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void swTimerStop(sw_timer_t *p_timer)
+{
+	swTimerUnlink(p_timer);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerIsRunning()
+*
+* Description:	Checks whether a timer is running.
+*
+* Returns:		1 if the timer is running, otherwise 0.
+*
+****************************************************************************/
+
+uint32_t swTimerIsRunning(const sw_timer_t *p_timer)
+{
+	return (p_timer->pprev != NULL) ? 1U : 0U;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerTick()
+*
+* Description:	Processes one tick: moves down the timers of the next slot of
+* 				the upper levels when level 0 wraps, then runs the callbacks of
+* 				the timers due in this tick. Periodic timers are restarted
+* 				before their callback is called.
+*
+* Returns:		None.
+*
+* Notes:		Called once per scheduler tick, from a task.
+*
+****************************************************************************/
+
+void swTimerTick(void)
+{
+
+	uint32_t slot = sw_timer_now & SW_TIMER_MASK;
+	uint32_t level;
+	sw_timer_t *p_due;
+	sw_timer_t *p_timer;
+
+	/* Level 0 wraps: move the timers due in the next SW_TIMER_SLOTS ticks
+	 * down from level 1, and from level 2 if level 1 wraps too, etc. */
+	if (slot == 0U)
+	{
+		level = 1U;
+		while ( (level < SW_TIMER_LEVELS)
+				&& (swTimerCascade(level, (sw_timer_now >> (SW_TIMER_BITS * level)) & SW_TIMER_MASK) == 0U) )
+		{
+			level++;
+		}
+	}
+
+	/* Take the list of due timers; timers started from the callbacks are
+	 * linked for later ticks. */
+	p_due = SwTimerWheel[0][slot];
+	SwTimerWheel[0][slot] = NULL;
+	if (p_due != NULL)
+	{
+		p_due->pprev = &p_due;
+	}
+	sw_timer_now++;
+
+	while (p_due != NULL)
+	{
+		p_timer = p_due;
+		swTimerUnlink(p_timer);
+
+		if (p_timer->period != 0U)
+		{
+			p_timer->expires += p_timer->period;
+			swTimerLink(p_timer);
+		}
+
+		p_timer->func(p_timer->p_arg);
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerNow()
+*
+* Description:	Returns the number of ticks processed by swTimerTick().
+*
+* Returns:		Tick count (wraps at 2^32).
+*
+****************************************************************************/
+
+uint32_t swTimerNow(void)
+{
+	return sw_timer_now;
+}
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerLink()
+*
+* Description:	Links a timer into the slot of its expiry tick: the lowest
+* 				level whose range covers the time to the expiry.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void swTimerLink(sw_timer_t *p_timer)
+{
+
+	uint32_t delta = p_timer->expires - sw_timer_now;
+	uint32_t level = 0U;
+	sw_timer_t **p_slot;
+
+	/* Already due (e.g. a periodic timer that fell behind): next tick */
+	if ((int32_t)delta < 0)
+	{
+		p_timer->expires = sw_timer_now;
+		delta = 0U;
+	}
+
+	while ( (level < (SW_TIMER_LEVELS - 1U)) && (delta >= (1U << (SW_TIMER_BITS * (level + 1U)))) )
+	{
+		level++;
+	}
+
+	p_slot = &SwTimerWheel[level][(p_timer->expires >> (SW_TIMER_BITS * level)) & SW_TIMER_MASK];
+
+	p_timer->next = *p_slot;
+	if (*p_slot != NULL)
+	{
+		(*p_slot)->pprev = &p_timer->next;
+	}
+	*p_slot = p_timer;
+	p_timer->pprev = p_slot;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerUnlink()
+*
+* Description:	Unlinks a timer from its slot, if it is running.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void swTimerUnlink(sw_timer_t *p_timer)
+{
+
+	if (p_timer->pprev == NULL)
+	{
+		return;
+	}
+
+	*p_timer->pprev = p_timer->next;
+	if (p_timer->next != NULL)
+	{
+		p_timer->next->pprev = p_timer->pprev;
+	}
+	p_timer->next = NULL;
+	p_timer->pprev = NULL;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		swTimerCascade()
+*
+* Description:	Moves the timers of one slot of an upper level down, each to
+* 				the slot of its expiry tick.
+*
+* param[in]		level: Level (1 to SW_TIMER_LEVELS - 1).
+* param[in]		slot: Slot in that level.
+*
+* Returns:		The slot number, so that the caller knows when the level
+* 				wraps (slot 0) and the next level must be moved down too.
+*
+****************************************************************************/
+
+uint32_t swTimerCascade(uint32_t level, uint32_t slot)
+{
+
+	sw_timer_t *p_list = SwTimerWheel[level][slot];
+	sw_timer_t *p_timer;
+
+	SwTimerWheel[level][slot] = NULL;
+
+	while (p_list != NULL)
+	{
+		p_timer = p_list;
+		p_list = p_list->next;
+		swTimerLink(p_timer);
+	}
+
+	return slot;
+
+}
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
@@ -0,0 +1,385 @@
+/******************************************************************************
+ * @Title		:	Telemetry Subscriptions
+ * @Filename	:	telemetry.c
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+#include "telemetry.h"
+
+
+
+/*****************************************************************************/
+/************************** Variable Declarations ****************************/
+/*****************************************************************************/
+
+/* Subscription table */
+static telem_sub_t		TelemTable[TELEM_MAX_SUBS];
+
+/* Statistics */
+static telem_stats_t	TelemStats;
+static telem_stats_t	*p_TelemStats = &TelemStats;
+
+
+
+/****************************************************************************/
+/************************** Function Prototypes *****************************/
+/****************************************************************************/
+
+/* Command handlers */
+static uint32_t telemSubscribePeriodicCmd(uint32_t field1, uint32_t field2);
+static uint32_t telemSubscribeOnChangeCmd(uint32_t field1, uint32_t field2);
+static uint32_t telemUnsubscribeCmd(uint32_t field1, uint32_t field2);
+static uint32_t telemStatsCmd(uint32_t field1, uint32_t field2);
+
+/* Functions internal to this file */
+static uint32_t telemSubscribe(uint32_t mode, uint32_t address, uint32_t period);
+static void telemPush(uint32_t id, telem_sub_t *p_sub, uint32_t value, XTime timestamp);
+
+
+
+/*---------------------------------------------------------------------------*/
+/*------------------------------- FUNCTIONS ---------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+
+
+/******************************************************************************
+*
+* Function:		telemRegisterCommands()
+*
+* Description:	Clears the subscription table, and registers SUBSCRIBE_PERIODIC,
+* 				SUBSCRIBE_ON_CHANGE, UNSUBSCRIBE and GET_TELEM_STATS with the
+* 				command handler.
+*
+* Returns:		XST_SUCCESS, or XST_FAILURE if registration failed.
+*
+* Notes:		cmdHandlerInit() must be called first.
+*
+****************************************************************************/
+
+int telemRegisterCommands(void)
+{
+
+	int status = XST_SUCCESS;
+	uint32_t idx;
+
+	for (idx = 0; idx < TELEM_MAX_SUBS; idx++)
+	{
+		TelemTable[idx].active = 0U;
+	}
+
+	p_TelemStats->n_sent = 0U;
+	p_TelemStats->n_dropped = 0U;
+
+	status |= registerCommand(SUBSCRIBE_PERIODIC, telemSubscribePeriodicCmd);
+	status |= registerCommand(SUBSCRIBE_ON_CHANGE, telemSubscribeOnChangeCmd);
+	status |= registerCommand(UNSUBSCRIBE, telemUnsubscribeCmd);
+	status |= registerCommand(GET_TELEM_STATS, telemStatsCmd);
+
+	return (status == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		telemTick()
+*
+* Description:	Counts down the period of each active subscription. When it
+* 				expires, the register is read and timestamped, and (for
+* 				ON_CHANGE, only if the value has changed) a telemetry frame is
+* 				pushed to the host.
+*
+* Returns:		None.
+*
+* Notes:		Called once per TTC0 cycle, from the main loop. A frame that
+* 				cannot be queued is dropped and counted; an ON_CHANGE value
+* 				that was dropped is sent again on its next sample.
+*
+****************************************************************************/
+
+void telemTick(void)
+{
+
+	uint32_t idx;
+	uint32_t value;
+	XTime timestamp;
+	telem_sub_t *p_sub;
+
+	for (idx = 0; idx < TELEM_MAX_SUBS; idx++)
+	{
+		p_sub = &TelemTable[idx];
+
+		if (p_sub->active == 0U)
+		{
+			continue;
+		}
+
+		p_sub->countdown--;
+		if (p_sub->countdown != 0U)
+		{
+			continue;
+		}
+		p_sub->countdown = p_sub->period;
+
+		/* Sample */
+		XTime_GetTime(&timestamp);
+		value = Xil_In32(p_sub->address);
+
+		if ( (p_sub->mode == TELEM_MODE_PERIODIC)
+				|| (p_sub->sent_once == 0U)
+				|| (value != p_sub->last_value) )
+		{
+			telemPush(idx, p_sub, value, timestamp);
+		}
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		telemSubscribePeriodicCmd()
+*
+* Description:	SUBSCRIBE_PERIODIC: pushes the value of a register every
+* 				Field 2 TTC0 cycles. Field 1 = address.
+*
+* Returns:		Subscription ID, or CMD_ERROR (see telemSubscribe()).
+*
+****************************************************************************/
+
+uint32_t telemSubscribePeriodicCmd(uint32_t field1, uint32_t field2)
+{
+	return telemSubscribe(TELEM_MODE_PERIODIC, field1, field2);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		telemSubscribeOnChangeCmd()
+*
+* Description:	SUBSCRIBE_ON_CHANGE: samples a register every Field 2 TTC0
+* 				cycles, and pushes the value when it differs from the last
+* 				value pushed (the first sample is always pushed).
+* 				Field 1 = address.
+*
+* Returns:		Subscription ID, or CMD_ERROR (see telemSubscribe()).
+*
+****************************************************************************/
+
+uint32_t telemSubscribeOnChangeCmd(uint32_t field1, uint32_t field2)
+{
+	return telemSubscribe(TELEM_MODE_ON_CHANGE, field1, field2);
+}
+
+
+
+/******************************************************************************
+*
+* Function:		telemUnsubscribeCmd()
+*
+* Description:	UNSUBSCRIBE: cancels a subscription.
+* 				Field 1 = subscription ID, or TELEM_ALL.
+*
+* Returns:		WRITE_OKAY, or CMD_ERROR if the ID is not active.
+*
+****************************************************************************/
+
+uint32_t telemUnsubscribeCmd(uint32_t field1, uint32_t field2)
+{
+
+	uint32_t idx;
+
+	if (field1 == TELEM_ALL)
+	{
+		for (idx = 0; idx < TELEM_MAX_SUBS; idx++)
+		{
+			TelemTable[idx].active = 0U;
+		}
+		return WRITE_OKAY;
+	}
+
+	if ( (field1 >= TELEM_MAX_SUBS) || (TelemTable[field1].active == 0U) )
+	{
+		return CMD_ERROR;
+	}
+
+	TelemTable[field1].active = 0U;
+	return WRITE_OKAY;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		telemStatsCmd()
+*
+* Description:	GET_TELEM_STATS: reads or clears the telemetry statistics.
+* 				Field 1 = selector (TELEM_STATS_xxx).
+*
+* Returns:		The selected value (WRITE_OKAY for TELEM_STATS_CLEAR), or
+* 				CMD_ERROR for an unknown selector.
+*
+****************************************************************************/
+
+uint32_t telemStatsCmd(uint32_t field1, uint32_t field2)
+{
+
+	uint32_t idx;
+	uint32_t n_active = 0U;
+
+	switch (field1)
+	{
+	case TELEM_STATS_SENT:
+		return p_TelemStats->n_sent;
+
+	case TELEM_STATS_DROPPED:
+		return p_TelemStats->n_dropped;
+
+	case TELEM_STATS_ACTIVE:
+		for (idx = 0; idx < TELEM_MAX_SUBS; idx++)
+		{
+			n_active += TelemTable[idx].active;
+		}
+		return n_active;
+
+	case TELEM_STATS_CLEAR:
+		p_TelemStats->n_sent = 0U;
+		p_TelemStats->n_dropped = 0U;
+		return WRITE_OKAY;
+
+	default:
+		return CMD_ERROR;
+	}
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		telemSubscribe()
+*
+* Description:	Adds a subscription to the first free entry of the table.
+* 				The first sample is taken on the next TTC0 cycle.
+*
+* param[in]		mode: TELEM_MODE_xxx.
+* param[in]		address: Register address.
+* param[in]		period: TTC0 cycles between samples (>= 1).
+*
+* Returns:		Subscription ID (table index), or CMD_ERROR if the period is 0,
+* 				the table is full, or the framed protocol is not in use.
+*
+****************************************************************************/
+
+uint32_t telemSubscribe(uint32_t mode, uint32_t address, uint32_t period)
+{
+
+	uint32_t idx;
+	telem_sub_t *p_sub;
+
+	if ( (FRAME_PROTOCOL_FRAMED == 0) || (period == 0U) )
+	{
+		return CMD_ERROR;
+	}
+
+	for (idx = 0; idx < TELEM_MAX_SUBS; idx++)
+	{
+		p_sub = &TelemTable[idx];
+
+		if (p_sub->active == 0U)
+		{
+			p_sub->mode = mode;
+			p_sub->address = address;
+			p_sub->period = period;
+			p_sub->countdown = 1U;
+			p_sub->seq = 0U;
+			p_sub->sent_once = 0U;
+			p_sub->active = 1U;
+			return idx;
+		}
+	}
+
+	return CMD_ERROR;
+
+}
+
+
+
+/******************************************************************************
+*
+* Function:		telemPush()
+*
+* Description:	Builds a telemetry frame and queues it for the host.
+*
+* param[in]		id: Subscription ID.
+* param[in]		*p_sub: The subscription.
+* param[in]		value: Sampled register value.
+* param[in]		timestamp: Global Timer count at the sample.
+*
+* Returns:		None.
+*
+****************************************************************************/
+
+void telemPush(uint32_t id, telem_sub_t *p_sub, uint32_t value, XTime timestamp)
+{
+
+	uint8_t frame[TELEM_FRAME_NBYTES];
+
+	setResponseBytes(&frame[0], (id << 24) | (p_sub->seq & 0x00FFFFFFU));
+	setResponseBytes(&frame[4], (uint32_t)(timestamp >> 32));
+	setResponseBytes(&frame[8], (uint32_t)timestamp);
+	setResponseBytes(&frame[12], value);
+	p_sub->seq++;
+
+	if (sendDeferredResponse(FRAME_TAG_UNSOLICITED, frame, TELEM_FRAME_NBYTES) == XST_SUCCESS)
+	{
+		p_sub->last_value = value;
+		p_sub->sent_once = 1U;
+		p_TelemStats->n_sent++;
+	}
+	else
+	{
+		p_TelemStats->n_dropped++;
+	}
+
+}
+
+
+
+/****** End functions *****/
+
+/****** End of File **********************************************************/
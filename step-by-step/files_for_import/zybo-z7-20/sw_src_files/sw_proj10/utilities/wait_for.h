@@ -0,0 +1,88 @@
+/******************************************************************************
+ * @Title		:	WAIT_FOR Condition Monitor (Header File)
+ * @Filename	:	wait_for.h
+ * @Author		:	Derek Murray
+ * @Origin Date	:	16/10/2026
+ * @Version		:	1.0.0
+ * @Compiler	:	arm-none-eabi-gcc
+ * @Target		: 	Xilinx Zynq-7000
+ * @Platform	: 	Digilent Zybo-Z7-20
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Copyright (C) 2021  Derek Murray
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+******************************************************************************/
+
+#ifndef SRC_UTILITIES_WAIT_FOR_H_
+#define SRC_UTILITIES_WAIT_FOR_H_
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+
+/* Xilinx files */
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
+
+/* Command handler (response codes, deferred responses) */
+#include "cmd_handler.h"
+
+
+/*****************************************************************************/
+/************************** Constant Definitions *****************************/
+/*****************************************************************************/
+
+/* Number of WAIT_FOR requests that can be pending at the same time */
+#define WAIT_FOR_MAX_PENDING		4U
+
+/* Size of the WAIT_FOR response (STATUS + REG VALUE) */
+#define WAIT_FOR_RESP_NBYTES		8U
+
+
+/*****************************************************************************/
+/******************************* Typedefs ************************************/
+/*****************************************************************************/
+
+/* A pending WAIT_FOR request */
+typedef struct {
+	uint32_t active;			// Entry in use
+	uint32_t done;				// Result known, response not yet sent
+	uint32_t request_id;		// Comms block request identifier (tag)
+	uint32_t address;
+	uint32_t mask;
+	uint32_t value;
+	uint32_t ticks_left;		// Remaining timeout, TTC0 cycles
+	uint32_t status;			// WRITE_OKAY or WAIT_TIMEOUT
+	uint32_t reg_value;			// Last value read
+} wait_for_t;
+
+
+/*****************************************************************************/
+/************************** Function Prototypes ******************************/
+/*****************************************************************************/
+
+/* Called by the command handler for WAIT_FOR */
+uint32_t waitForStart(uint32_t address, uint32_t mask, uint32_t value,
+						uint32_t timeout, uint32_t request_id, uint8_t *tx_buffer);
+
+/* Called once per TTC0 cycle from the main loop */
+void waitForTick(void);
+
+
+#endif /* SRC_UTILITIES_WAIT_FOR_H_ */
@@ -85,9 +85,7 @@ int xScuWdtInit(void){
 	XScuWdt_Config *p_XScuWdtCfg = NULL;
 
 
-#if SCUWDT_DEBUG
 	checkRebootStatus();
-#endif
 
 	/* === START CONFIGURATION SEQUENCE ===  */
 
@@ -167,13 +165,14 @@ void restartScuWdt(void)
  * Function: checkRebootStatus()
  *//**
  *
- * @brief		Reads the SLCR Reboot status register and prints out the status
- * 				of possible reboot causes.
+ * @brief		Reads the SLCR Reboot status register, logs it, and prints out
+ * 				the status of possible reboot causes.
  *
  * @return		None.
  *
  * @note		This function is only really meant for debug/informative
- * 				reasons. A terminal must be connected.
+ * 				reasons. The log record is always written (see logger.h); the
+ * 				printout needs SCUWDT_DEBUG and a connected terminal.
  *
 ******************************************************************************/
 
@@ -181,6 +180,12 @@ void checkRebootStatus(void){
 
 	uint32_t slcr_reboot_sts = Xil_In32(SLCR_REBOOT_STATUS_REG);
 
+	LOG4(LOG_REBOOT_STATUS, slcr_reboot_sts,
+			( (slcr_reboot_sts & SLCR_RS_SWDT_RST_MASK) != 0),
+			( (slcr_reboot_sts & SLCR_RS_AWDT0_RST_MASK) != 0),
+			( (slcr_reboot_sts & SLCR_RS_AWDT1_RST_MASK) != 0) );
+
+#if SCUWDT_DEBUG
 	printf("\r\n-----------------------------------------------------------\r\n");
 	printf("SLCR Reboot Status Register: \r\n");
 	printf("SWDT_RST  = %x\r\n", ( (slcr_reboot_sts & SLCR_RS_SWDT_RST_MASK) != 0) );
@@ -192,6 +197,7 @@ void checkRebootStatus(void){
 	printf("POR       = %x\r\n", ( (slcr_reboot_sts & SLCR_RS_POR_MASK) != 0) );
 	printf("(Note: Power-cycle (POR) required to clear this register.)\r\n");
 	printf("-----------------------------------------------------------\r\n\r\n");
+#endif
 }
 
 /****** End functions *****/
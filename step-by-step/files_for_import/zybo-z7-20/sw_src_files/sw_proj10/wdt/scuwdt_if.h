@@ -36,6 +36,9 @@
 
 #include "xscuwdt.h"
 
+/* Deferred logger (reboot status) */
+#include "../utilities/logger.h"
+
 
 /*****************************************************************************/
 /************************** Constant Definitions *****************************/